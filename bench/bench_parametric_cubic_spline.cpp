@@ -0,0 +1,523 @@
+/*
+ * MIT License
+ *
+ * Parametric Cubic Spline Library
+ * Copyright (c) 2021-, Michael Heidingsfeld
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "parametric_cubic_spline/parametric_cubic_spline.h"
+#include "parametric_cubic_spline/spline_bank.h"
+#include "parametric_cubic_spline/spline_file.h"
+#include "parametric_cubic_spline/non_uniform_spline.h"
+#include "parametric_cubic_spline/streaming_spline.h"
+#include "parametric_cubic_spline/lazy_spline.h"
+#include "parametric_cubic_spline/spline_file_builder.h"
+
+using namespace parametric_cubic_spline;
+
+template<typename T>
+static std::vector<T> make_points(std::size_t num_points, std::size_t num_dims)
+{
+    std::vector<T> points(num_points*num_dims);
+    for(std::size_t i = 0; i < num_points; i++)
+    {
+        for(std::size_t j = 0; j < num_dims; j++)
+        {
+            points[i*num_dims+j] = std::sin(0.1*i + j);
+        }
+    }
+    return points;
+}
+
+template<typename T>
+static std::vector<T> make_positions(std::size_t num_pos)
+{
+    std::vector<T> pos(num_pos);
+    for(std::size_t i = 0; i < num_pos; i++)
+    {
+        pos[i] = T(i)/(num_pos - 1);
+    }
+    return pos;
+}
+
+template<typename T, bool UseCoefficientCache>
+static void BM_Eval(benchmark::State &state)
+{
+    const std::size_t num_points = state.range(0);
+    const std::size_t num_dims = 3;
+    const std::size_t num_pos = 1024;
+    std::vector<T> points = make_points<T>(num_points, num_dims);
+    std::vector<T> pos = make_positions<T>(num_pos);
+    std::vector<T> out(num_pos*num_dims);
+
+    Spline<T, Dynamic, Dynamic> spline;
+    spline.enable_coefficient_cache(UseCoefficientCache);
+    spline.set(points.data(), num_points, num_dims);
+
+    for(auto _ : state)
+    {
+        spline.eval(pos.data(), num_pos, out.data());
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations()*num_pos);
+}
+
+BENCHMARK_TEMPLATE(BM_Eval, float, false)->Arg(16)->Arg(4096);
+BENCHMARK_TEMPLATE(BM_Eval, float, true)->Arg(16)->Arg(4096);
+BENCHMARK_TEMPLATE(BM_Eval, double, false)->Arg(16)->Arg(4096);
+BENCHMARK_TEMPLATE(BM_Eval, double, true)->Arg(16)->Arg(4096);
+
+template<typename T, bool UseFactorizationCache>
+static void BM_Set(benchmark::State &state)
+{
+    const std::size_t num_points = state.range(0);
+    const std::size_t num_dims = 3;
+    std::vector<T> points = make_points<T>(num_points, num_dims);
+
+    Spline<T, Dynamic, Dynamic> spline;
+    spline.enable_factorization_cache(UseFactorizationCache);
+
+    for(auto _ : state)
+    {
+        spline.set(points.data(), num_points, num_dims,
+            BoundaryCondition::Periodic, BoundaryCondition::Periodic);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations()*num_points);
+}
+
+BENCHMARK_TEMPLATE(BM_Set, double, false)->Arg(16)->Arg(4096);
+BENCHMARK_TEMPLATE(BM_Set, double, true)->Arg(16)->Arg(4096);
+
+template<typename T, bool UseCursor>
+static void BM_EvalSorted(benchmark::State &state)
+{
+    const std::size_t num_points = state.range(0);
+    const std::size_t num_dims = 3;
+    const std::size_t num_pos = 4096;
+    std::vector<T> points = make_points<T>(num_points, num_dims);
+    std::vector<T> pos = make_positions<T>(num_pos);
+    std::vector<T> out(num_pos*num_dims);
+
+    Spline<T, Dynamic, Dynamic> spline;
+    spline.set(points.data(), num_points, num_dims);
+    typename Spline<T, Dynamic, Dynamic>::Cursor cursor;
+
+    for(auto _ : state)
+    {
+        if(UseCursor) spline.eval(cursor, pos.data(), num_pos, out.data());
+        else spline.eval(pos.data(), num_pos, out.data());
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations()*num_pos);
+}
+
+BENCHMARK_TEMPLATE(BM_EvalSorted, double, false)->Arg(16)->Arg(1024);
+BENCHMARK_TEMPLATE(BM_EvalSorted, double, true)->Arg(16)->Arg(1024);
+
+template<typename T>
+static void BM_EvalUniform(benchmark::State &state)
+{
+    const std::size_t num_points = state.range(0);
+    const std::size_t num_dims = 3;
+    const std::size_t num_pos = 4096;
+    std::vector<T> points = make_points<T>(num_points, num_dims);
+    std::vector<T> out(num_pos*num_dims);
+
+    Spline<T, Dynamic, Dynamic> spline;
+    spline.set(points.data(), num_points, num_dims);
+
+    for(auto _ : state)
+    {
+        spline.eval_uniform(num_pos, out.data());
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations()*num_pos);
+}
+
+BENCHMARK_TEMPLATE(BM_EvalUniform, float)->Arg(16)->Arg(1024);
+BENCHMARK_TEMPLATE(BM_EvalUniform, double)->Arg(16)->Arg(1024);
+
+static void BM_SetParallel(benchmark::State &state)
+{
+    const std::size_t num_points = 1 << 20;
+    const std::size_t num_dims = 3;
+    std::vector<double> points = make_points<double>(num_points, num_dims);
+
+    Spline<double, Dynamic, Dynamic> spline;
+    spline.enable_factorization_cache(true);
+    spline.set_num_threads(state.range(0));
+
+    for(auto _ : state)
+    {
+        spline.set(points.data(), num_points, num_dims,
+            BoundaryCondition::Periodic, BoundaryCondition::Periodic);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations()*num_points);
+}
+
+BENCHMARK(BM_SetParallel)->Arg(1)->Arg(2)->Arg(4)->Arg(0)->UseRealTime();
+
+template<bool UseBatch>
+static void BM_SetBatch(benchmark::State &state)
+{
+    const std::size_t num_splines = 1024;
+    const std::size_t num_points = state.range(0);
+    const std::size_t num_dims = 3;
+    std::vector<double> points = make_points<double>(num_splines*num_points, num_dims);
+    std::vector<const double*> pointers(num_splines);
+    for(std::size_t k = 0; k < num_splines; k++)
+    {
+        pointers[k] = &points[k*num_points*num_dims];
+    }
+
+    std::vector<Spline<double, Dynamic, Dynamic>> splines(num_splines);
+    for(auto _ : state)
+    {
+        if(UseBatch)
+        {
+            Spline<double, Dynamic, Dynamic>::set_batch(splines.data(), pointers.data(),
+                num_splines, num_points, num_dims);
+        }
+        else
+        {
+            for(std::size_t k = 0; k < num_splines; k++)
+            {
+                splines[k].set(pointers[k], num_points, num_dims);
+            }
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations()*num_splines);
+}
+
+BENCHMARK_TEMPLATE(BM_SetBatch, false)->Arg(4)->Arg(16)->Arg(64);
+BENCHMARK_TEMPLATE(BM_SetBatch, true)->Arg(4)->Arg(16)->Arg(64);
+
+template<typename T, std::size_t NumPoints>
+static void BM_SetFixed(benchmark::State &state)
+{
+    const std::size_t num_points = 8;
+    const std::size_t num_dims = 3;
+    std::vector<T> points = make_points<T>(num_points, num_dims);
+
+    Spline<T, NumPoints, 3> spline;
+    for(auto _ : state)
+    {
+        spline.set(points.data(), num_points,
+            BoundaryCondition::Natural, BoundaryCondition::Natural);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK_TEMPLATE(BM_SetFixed, float, Dynamic);
+BENCHMARK_TEMPLATE(BM_SetFixed, float, 8);
+BENCHMARK_TEMPLATE(BM_SetFixed, double, Dynamic);
+BENCHMARK_TEMPLATE(BM_SetFixed, double, 8);
+
+template<typename Layout>
+static void BM_EvalLayout(benchmark::State &state)
+{
+    const std::size_t num_points = 64;
+    const std::size_t num_dims = state.range(0);
+    const std::size_t num_pos = 1024;
+    std::vector<double> points = make_points<double>(num_points, num_dims);
+    std::vector<double> pos = make_positions<double>(num_pos);
+    std::vector<double> out(num_pos*num_dims);
+
+    Spline<double, Dynamic, Dynamic, Layout> spline;
+    spline.enable_coefficient_cache();
+    for(auto _ : state)
+    {
+        spline.set(points.data(), num_points, num_dims);
+        spline.eval(pos.data(), num_pos, out.data());
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(state.iterations()*num_pos);
+}
+
+BENCHMARK_TEMPLATE(BM_EvalLayout, layout::AoS)->Arg(2)->Arg(16);
+BENCHMARK_TEMPLATE(BM_EvalLayout, layout::SoA)->Arg(2)->Arg(16);
+BENCHMARK_TEMPLATE(BM_EvalLayout, layout::AoSoA<4>)->Arg(2)->Arg(16);
+
+static void BM_Multichannel(benchmark::State &state)
+{
+    const std::size_t num_points = 512;
+    const std::size_t num_dims = 4096;
+    const std::size_t num_pos = 1024;
+    std::vector<double> points = make_points<double>(num_points, num_dims);
+    std::vector<double> pos = make_positions<double>(num_pos);
+    std::vector<double> out(num_pos*num_dims);
+
+    Spline<double, Dynamic, Dynamic> spline;
+    spline.set_num_threads(state.range(0));
+    for(auto _ : state)
+    {
+        spline.set(points.data(), num_points, num_dims);
+        spline.eval(pos.data(), num_pos, out.data());
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(state.iterations()*num_pos*num_dims);
+}
+
+BENCHMARK(BM_Multichannel)->Arg(1)->Arg(0)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+static void BM_EvalParallel(benchmark::State &state)
+{
+    const std::size_t num_points = 4096;
+    const std::size_t num_dims = 3;
+    const std::size_t num_pos = 1 << 20;
+    std::vector<double> points = make_points<double>(num_points, num_dims);
+    std::vector<double> pos = make_positions<double>(num_pos);
+    std::vector<double> out(num_pos*num_dims);
+
+    Spline<double, Dynamic, Dynamic> spline;
+    spline.enable_coefficient_cache();
+    spline.set(points.data(), num_points, num_dims);
+    for(auto _ : state)
+    {
+        spline.eval_parallel(pos.data(), num_pos, out.data(), state.range(0));
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(state.iterations()*num_pos);
+}
+
+BENCHMARK(BM_EvalParallel)->Arg(1)->Arg(0)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+template<bool UseBank>
+static void BM_EvalBank(benchmark::State &state)
+{
+    const std::size_t num_splines = state.range(0);
+    const std::size_t num_dims = 2;
+    const std::size_t num_queries = 1 << 16;
+    std::vector<double> points = make_points<double>(num_splines*16, num_dims);
+
+    SplineBank<double> bank(num_dims);
+    std::vector<Spline<double, Dynamic, Dynamic>> splines(num_splines);
+    for(std::size_t k = 0; k < num_splines; k++)
+    {
+        const std::size_t num_points = 4 + k % 13;
+        bank.add(&points[16*k*num_dims], num_points);
+        splines[k].enable_coefficient_cache();
+        splines[k].set(&points[16*k*num_dims], num_points, num_dims);
+    }
+
+    std::vector<std::size_t> ids(num_queries);
+    std::vector<double> pos(num_queries), out(num_queries*num_dims);
+    for(std::size_t q = 0; q < num_queries; q++)
+    {
+        ids[q] = (q*7919) % num_splines;
+        pos[q] = double((q*104729) % 1000)/999;
+    }
+
+    for(auto _ : state)
+    {
+        if(UseBank)
+        {
+            bank.eval(ids.data(), pos.data(), num_queries, out.data());
+        }
+        else
+        {
+            for(std::size_t q = 0; q < num_queries; q++)
+            {
+                splines[ids[q]].eval(pos[q], &out[q*num_dims]);
+            }
+        }
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(state.iterations()*num_queries);
+}
+
+BENCHMARK_TEMPLATE(BM_EvalBank, false)->Arg(1024)->Arg(200000);
+BENCHMARK_TEMPLATE(BM_EvalBank, true)->Arg(1024)->Arg(200000);
+
+template<bool UseFile>
+static void BM_ColdStart(benchmark::State &state)
+{
+    const std::size_t num_splines = state.range(0);
+    const std::size_t num_dims = 2;
+    std::vector<double> points = make_points<double>(num_splines*16, num_dims);
+
+    SplineFileWriter<double> writer(num_dims);
+    for(std::size_t k = 0; k < num_splines; k++)
+    {
+        writer.add(&points[16*k*num_dims], 4 + k % 13);
+    }
+    const std::string path = "bench_spline_file.bin";
+    writer.write(path);
+
+    double out[num_dims];
+    for(auto _ : state)
+    {
+        // build or open all splines and touch every one of them once
+        if(UseFile)
+        {
+            SplineFile<double> file;
+            file.open(path);
+            for(std::size_t k = 0; k < num_splines; k++) file.eval(k, 0.5, out);
+        }
+        else
+        {
+            SplineBank<double> bank(num_dims);
+            for(std::size_t k = 0; k < num_splines; k++) bank.add(&points[16*k*num_dims], 4 + k % 13);
+            for(std::size_t k = 0; k < num_splines; k++) bank.eval(k, 0.5, out);
+        }
+        benchmark::DoNotOptimize(out);
+    }
+    std::remove(path.c_str());
+}
+
+BENCHMARK_TEMPLATE(BM_ColdStart, false)->Arg(200000)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_ColdStart, true)->Arg(200000)->Unit(benchmark::kMillisecond);
+
+static void BM_EvalNonUniform(benchmark::State &state)
+{
+    const std::size_t num_points = state.range(0);
+    const std::size_t num_dims = 2;
+    const std::size_t num_pos = 1 << 16;
+    std::vector<double> points = make_points<double>(num_points, num_dims);
+    // strongly uneven spacing
+    for(std::size_t i = 0; i < num_points; i++)
+    {
+        points[i*num_dims] = std::pow(double(i)/num_points, 3.0);
+    }
+    NonUniformSpline<double> spline;
+    spline.set(points.data(), num_points, num_dims, Parameterization::ChordLength);
+
+    std::vector<double> pos(num_pos), out(num_pos*num_dims);
+    for(std::size_t k = 0; k < num_pos; k++) pos[k] = double((k*104729) % 1000)/999;
+
+    for(auto _ : state)
+    {
+        spline.eval(pos.data(), num_pos, out.data());
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(state.iterations()*num_pos);
+}
+
+BENCHMARK(BM_EvalNonUniform)->Arg(64)->Arg(1 << 16)->Arg(1 << 20);
+
+static void BM_UpdatePoint(benchmark::State &state)
+{
+    const std::size_t num_points = state.range(0);
+    const std::size_t num_dims = 2;
+    std::vector<double> points = make_points<double>(num_points, num_dims);
+    Spline<double, Dynamic, Dynamic> spline;
+    spline.enable_coefficient_cache();
+    spline.set(points.data(), num_points, num_dims);
+
+    const std::size_t i = num_points/2;
+    double old_point[num_dims];
+    for(auto _ : state)
+    {
+        std::copy(&points[i*num_dims], &points[(i+1)*num_dims], old_point);
+        points[i*num_dims] += 0.5;
+        spline.update_point(i, old_point);
+        benchmark::DoNotOptimize(points.data());
+    }
+}
+
+BENCHMARK(BM_UpdatePoint)->Arg(1 << 10)->Arg(100000);
+
+static void BM_StreamAppend(benchmark::State &state)
+{
+    const std::size_t capacity = state.range(0);
+    const std::size_t num_dims = 3;
+    const std::size_t num_points = 4096;
+    std::vector<double> points = make_points<double>(num_points, num_dims);
+    StreamingSpline<double> spline(num_dims, capacity);
+
+    std::size_t k = 0;
+    for(auto _ : state)
+    {
+        spline.append(&points[k*num_dims]);
+        k = (k + 1) % num_points;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_StreamAppend)->Arg(1 << 10)->Arg(1 << 20);
+
+template<bool Lazy>
+static void BM_SetEvalFew(benchmark::State &state)
+{
+    const std::size_t num_points = state.range(0);
+    const std::size_t num_dims = 2;
+    const std::size_t num_pos = 16;
+    std::vector<double> points = make_points<double>(num_points, num_dims);
+    std::vector<double> pos(num_pos), out(num_pos*num_dims);
+    for(std::size_t k = 0; k < num_pos; k++) pos[k] = double((k*104729) % 1000)/999;
+
+    Spline<double, Dynamic, Dynamic> spline;
+    LazySpline<double> lazy;
+    for(auto _ : state)
+    {
+        if(Lazy)
+        {
+            lazy.set(points.data(), num_points, num_dims);
+            lazy.eval(pos.data(), num_pos, out.data());
+        }
+        else
+        {
+            spline.set(points.data(), num_points, num_dims);
+            spline.eval(pos.data(), num_pos, out.data());
+        }
+        benchmark::DoNotOptimize(out.data());
+    }
+}
+
+BENCHMARK_TEMPLATE(BM_SetEvalFew, false)->Arg(1 << 20);
+BENCHMARK_TEMPLATE(BM_SetEvalFew, true)->Arg(1 << 20);
+
+static void BM_BuildOutOfCore(benchmark::State &state)
+{
+    const std::size_t num_points = state.range(0);
+    const std::size_t num_dims = 3;
+    std::vector<double> points = make_points<double>(num_points, num_dims);
+    const std::string input_path = "bench_out_of_core.points";
+    const std::string output_path = "bench_out_of_core.bin";
+    {
+        std::ofstream file(input_path, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(points.data()), points.size()*sizeof(double));
+    }
+
+    SplineFileBuilder<double> builder(num_dims);
+    for(auto _ : state)
+    {
+        benchmark::DoNotOptimize(builder.build(input_path, output_path));
+    }
+    state.SetItemsProcessed(state.iterations()*num_points);
+    std::remove(input_path.c_str());
+    std::remove(output_path.c_str());
+}
+
+BENCHMARK(BM_BuildOutOfCore)->Arg(1 << 22)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,90 @@
+/*
+ * MIT License
+ *
+ * Parametric Cubic Spline Library
+ * Copyright (c) 2021-, Michael Heidingsfeld
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "parametric_cubic_spline/parametric_cubic_spline.h"
+
+namespace parametric_cubic_spline {
+
+/**
+ * Arc-length parameterization class
+ *
+ * Tabulates the cumulative arc length of a solved spline on equally spaced
+ * sub-intervals of the spline parameter with Gauss-Legendre quadrature. The
+ * inverse map is a branchless binary search over the table followed by cubic
+ * Hermite interpolation within the sub-interval.
+ */
+template<typename T>
+class ArcLength
+{
+    T length_;
+    T width_;
+    std::vector<T> lengths_;
+    std::vector<T> dpos_;
+
+public:
+    ArcLength();
+
+    // build tables of a solved spline
+    template<std::size_t NumPoints, std::size_t NumDims, typename Layout>
+    void set(
+        const Spline<T, NumPoints, NumDims, Layout> &spline,
+        const std::size_t samples_per_segment = 8
+    );
+
+    // total arc length
+    T length() const;
+
+    // spline parameter at arc length s in [0, length()], single point
+    T pos(const T s) const;
+
+    // spline parameter at arc lengths s in [0, length()], variable lengths
+    void pos(
+        const T *s,
+        const std::size_t num_s,
+        T *out_pos
+    ) const;
+
+    // evaluate spline at equally spaced arc lengths including both end points
+    template<std::size_t NumPoints, std::size_t NumDims, typename Layout>
+    void resample(
+        const Spline<T, NumPoints, NumDims, Layout> &spline,
+        const std::size_t num_samples,
+        T *out_points
+    ) const;
+
+private:
+    static T norm(
+        const T *v,
+        const std::size_t num_dims
+    );
+};
+
+} // namespace: parametric_cubic_spline
+
+#include "parametric_cubic_spline/impl/arc_length.hpp"
@@ -0,0 +1,209 @@
+/*
+ * MIT License
+ *
+ * Parametric Cubic Spline Library
+ * Copyright (c) 2021-, Michael Heidingsfeld
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace parametric_cubic_spline {
+
+namespace internal {
+
+    /**
+     * 5-point Gauss-Legendre rule on [-1, 1]
+     */
+    template<typename T>
+    struct GaussLegendre
+    {
+        static constexpr std::size_t size = 5;
+        static const T nodes[size];
+        static const T weights[size];
+    };
+
+    template<typename T>
+    const T GaussLegendre<T>::nodes[] = {
+        -0.9061798459386639927976, -0.5384693101056830910363, 0.0,
+         0.5384693101056830910363,  0.9061798459386639927976 };
+
+    template<typename T>
+    const T GaussLegendre<T>::weights[] = {
+        0.2369268850561890875143, 0.4786286704993664680413, 0.5688888888888888888889,
+        0.4786286704993664680413, 0.2369268850561890875143 };
+
+} // namespace: internal
+
+
+template<typename T>
+ArcLength<T>::ArcLength() :
+    length_(0.0),
+    width_(0.0)
+{
+    static_assert(std::is_floating_point<T>::value, "T must be a floating point type.");
+}
+
+template<typename T>
+template<std::size_t NumPoints, std::size_t NumDims, typename Layout>
+void ArcLength<T>::set(
+    const Spline<T, NumPoints, NumDims, Layout> &spline,
+    const std::size_t samples_per_segment
+)
+{
+    typedef internal::GaussLegendre<T> Rule;
+    const std::size_t num_dims = spline.num_dims();
+    const std::size_t num_intervals = samples_per_segment*(spline.num_points() - 1);
+    width_ = T(1.0)/num_intervals;
+
+    // Cumulative arc length at the boundaries of all sub-intervals, the
+    // quadrature nodes are evaluated in chunks through the batch interface
+    const std::size_t chunk = 256;
+    std::vector<T> nodes(chunk*Rule::size);
+    std::vector<T> derivatives(chunk*Rule::size*num_dims);
+    lengths_.resize(num_intervals + 1);
+    lengths_[0] = 0.0;
+    for(std::size_t k0 = 0; k0 < num_intervals; k0 += chunk)
+    {
+        std::size_t num_chunk = std::min(chunk, num_intervals - k0);
+        for(std::size_t k = 0; k < num_chunk; k++)
+        {
+            for(std::size_t l = 0; l < Rule::size; l++)
+            {
+                nodes[k*Rule::size+l] = (k0 + k + 0.5*(Rule::nodes[l] + 1.0))*width_;
+            }
+        }
+        spline.eval(nodes.data(), num_chunk*Rule::size, nullptr, derivatives.data(), nullptr);
+        for(std::size_t k = 0; k < num_chunk; k++)
+        {
+            T sum = 0.0;
+            for(std::size_t l = 0; l < Rule::size; l++)
+            {
+                sum += Rule::weights[l]*norm(&derivatives[(k*Rule::size+l)*num_dims], num_dims);
+            }
+            lengths_[k0+k+1] = lengths_[k0+k] + 0.5*width_*sum;
+        }
+    }
+    length_ = lengths_[num_intervals];
+
+    // Derivative d pos/d s = 1/|p'(pos)| at the sub-interval boundaries
+    std::vector<T> pos(num_intervals + 1);
+    derivatives.resize((num_intervals + 1)*num_dims);
+    for(std::size_t k = 0; k <= num_intervals; k++)
+    {
+        pos[k] = k*width_;
+    }
+    spline.eval(pos.data(), num_intervals + 1, nullptr, derivatives.data(), nullptr);
+    dpos_.resize(num_intervals + 1);
+    for(std::size_t k = 0; k <= num_intervals; k++)
+    {
+        T v = norm(&derivatives[k*num_dims], num_dims);
+        dpos_[k] = v > 0 ? 1.0/v : std::numeric_limits<T>::max();
+    }
+
+    // Limit slopes to three times the adjacent secants, this keeps the
+    // interpolation monotone close to points of vanishing speed
+    for(std::size_t k = 0; k <= num_intervals; k++)
+    {
+        if(k > 0 && lengths_[k] > lengths_[k-1])
+        {
+            dpos_[k] = std::min(dpos_[k], T(3.0)*width_/(lengths_[k] - lengths_[k-1]));
+        }
+        if(k < num_intervals && lengths_[k+1] > lengths_[k])
+        {
+            dpos_[k] = std::min(dpos_[k], T(3.0)*width_/(lengths_[k+1] - lengths_[k]));
+        }
+    }
+}
+
+template<typename T>
+T ArcLength<T>::length() const
+{
+    return length_;
+}
+
+template<typename T>
+T ArcLength<T>::pos(const T s) const
+{
+    // Branchless binary search for the last boundary with lengths_[k] <= s,
+    // the trip count only depends on the table size
+    const std::size_t num_intervals = lengths_.size() - 1;
+    std::size_t k = 0;
+    for(std::size_t len = num_intervals; len > 1;)
+    {
+        std::size_t half = len/2;
+        k = lengths_[k+half] <= s ? k + half : k;
+        len -= half;
+    }
+
+    // Cubic Hermite interpolation of pos(s) within sub-interval k
+    T h = lengths_[k+1] - lengths_[k];
+    T w = h > 0 ? (s - lengths_[k])/h : 0.0;
+    w = std::min(std::max(w, T(0.0)), T(1.0));
+    T w2 = w*w;
+    T w3 = w2*w;
+    return k*width_ + (w3 - 2.0*w2 + w)*h*dpos_[k]
+        + (3.0*w2 - 2.0*w3)*width_ + (w3 - w2)*h*dpos_[k+1];
+}
+
+template<typename T>
+void ArcLength<T>::pos(
+    const T *s,
+    const std::size_t num_s,
+    T *out_pos
+) const
+{
+    for(std::size_t i = 0; i < num_s; i++)
+    {
+        out_pos[i] = pos(s[i]);
+    }
+}
+
+template<typename T>
+template<std::size_t NumPoints, std::size_t NumDims, typename Layout>
+void ArcLength<T>::resample(
+    const Spline<T, NumPoints, NumDims, Layout> &spline,
+    const std::size_t num_samples,
+    T *out_points
+) const
+{
+    std::vector<T> pos(num_samples);
+    for(std::size_t i = 0; i < num_samples; i++)
+    {
+        pos[i] = this->pos(num_samples > 1 ? length_*i/(num_samples - 1) : 0.0);
+    }
+    spline.eval(pos.data(), num_samples, out_points, nullptr, nullptr);
+}
+
+template<typename T>
+T ArcLength<T>::norm(
+    const T *v,
+    const std::size_t num_dims
+)
+{
+    T sum = 0.0;
+    for(std::size_t j = 0; j < num_dims; j++) sum += v[j]*v[j];
+    return std::sqrt(sum);
+}
+
+} // namespace: parametric_cubic_spline
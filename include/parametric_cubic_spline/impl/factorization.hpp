@@ -0,0 +1,375 @@
+/*
+ * MIT License
+ *
+ * Parametric Cubic Spline Library
+ * Copyright (c) 2021-, Michael Heidingsfeld
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#pragma once
+
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <tuple>
+
+namespace parametric_cubic_spline {
+
+namespace internal {
+
+    /**
+     * Row i (a, b, c) of the uniform moment system
+     *
+     * Periodic boundaries keep the inner row, a of the first and c of the
+     * last row are then the corners of the perturbed problem. Constexpr for
+     * the compile-time factorization of the fixed-size solver.
+     */
+    template<typename T>
+    constexpr void moment_row(
+        const std::size_t n,
+        const BoundaryCondition left_bc,
+        const BoundaryCondition right_bc,
+        const std::size_t i,
+        T &a,
+        T &b,
+        T &c
+    )
+    {
+        a = 1.0;
+        b = 4.0;
+        c = 1.0;
+        if(i == 0)
+        {
+            switch(left_bc)
+            {
+            case BoundaryCondition::Hermite:
+                a = 0.0;
+                b = 2.0;
+                c = 1.0;
+                break;
+            case BoundaryCondition::Periodic:
+                break;
+            default: // BoundaryCondition::Natural, BoundaryCondition::NotAKnot
+                a = 0.0;
+                b = 1.0;
+                c = 0.0;
+            }
+        }
+        // M_0 = 2M_1 - M_2 turns row 1 into 6M_1 = d_1, row 0 is decoupled
+        // and M_0 extrapolated after the solve
+        if(i == 1 && n > 2 && left_bc == BoundaryCondition::NotAKnot)
+        {
+            a = 0.0;
+            b = 6.0;
+            c = 0.0;
+        }
+        if(i == n - 1)
+        {
+            switch(right_bc)
+            {
+            case BoundaryCondition::Hermite:
+                a = 1.0;
+                b = 2.0;
+                c = 0.0;
+                break;
+            case BoundaryCondition::Periodic:
+                break;
+            default: // BoundaryCondition::Natural, BoundaryCondition::NotAKnot
+                a = 0.0;
+                b = 1.0;
+                c = 0.0;
+            }
+        }
+        if(i + 2 == n && n > 2 && right_bc == BoundaryCondition::NotAKnot)
+        {
+            a = 0.0;
+            b = 6.0;
+            c = 0.0;
+        }
+    }
+
+    /**
+     * LU factorization of the moment system
+     *
+     * For uniform parameterization the system matrix only depends on the
+     * number of points and the boundary conditions. This stores the result of
+     * the forward elimination of the Thomas algorithm together with the
+     * Sherman-Morrison vector q of the perturbed (periodic) problem, such that
+     * solving for a new right-hand side only requires the substitution sweeps.
+     */
+    template<typename T, std::size_t N>
+    class Factorization
+    {
+    public:
+        std::size_t num_points;
+        BoundaryCondition left_bc;
+        BoundaryCondition right_bc;
+        bool is_perturbed;
+        bool left_not_a_knot;       // end moments extrapolated after the solve
+        bool right_not_a_knot;
+        StorageType<T, N> f;        // elimination multipliers
+        StorageType<T, N> inv_b;    // inverse pivots
+        StorageType<T, N> c;        // upper diagonal
+        StorageType<T, N> q;        // solution of A'q = u
+        T vn;                       // last component of v
+        T inv_vq;                   // 1/(1 + v^T q)
+
+        Factorization() :
+            num_points(0),
+            left_bc(BoundaryCondition::Natural),
+            right_bc(BoundaryCondition::Natural),
+            is_perturbed(false),
+            left_not_a_knot(false),
+            right_not_a_knot(false),
+            vn(0.0),
+            inv_vq(0.0)
+        {}
+
+        inline bool matches(
+            const std::size_t n,
+            const BoundaryCondition left,
+            const BoundaryCondition right
+        ) const
+        {
+            return num_points == n && left_bc == left && right_bc == right;
+        }
+
+        void compute(
+            const std::size_t n,
+            const BoundaryCondition left,
+            const BoundaryCondition right
+        );
+
+        // general matrix, row i is (lower[i], diag[i], upper[i]) with the
+        // periodic corners lower[0] and upper[n-1]
+        void compute(
+            const std::size_t n,
+            const BoundaryCondition left,
+            const BoundaryCondition right,
+            const T *lower,
+            const T *diag,
+            const T *upper
+        );
+
+    private:
+        void factorize();
+
+    public:
+
+        inline void reserve(const std::size_t n)
+        {
+            f.reserve(n);
+            inv_b.reserve(n);
+            c.reserve(n);
+            q.reserve(n);
+        }
+    };
+
+    template<typename T, std::size_t N>
+    void Factorization<T, N>::compute(
+        const std::size_t n,
+        const BoundaryCondition left,
+        const BoundaryCondition right
+    )
+    {
+        num_points = n;
+        left_bc = left;
+        right_bc = right;
+        f.resize(n);
+        inv_b.resize(n);
+        c.resize(n);
+
+        // Assemble matrix, a is stored in f and b in inv_b
+        StorageType<T, N> &a = f;
+        StorageType<T, N> &b = inv_b;
+        for(std::size_t i = 0; i < n; i++)
+        {
+            moment_row(n, left_bc, right_bc, i, a[i], b[i], c[i]);
+        }
+        left_not_a_knot = n > 2 && left_bc == BoundaryCondition::NotAKnot;
+        right_not_a_knot = n > 2 && right_bc == BoundaryCondition::NotAKnot;
+        factorize();
+    }
+
+    template<typename T, std::size_t N>
+    void Factorization<T, N>::compute(
+        const std::size_t n,
+        const BoundaryCondition left,
+        const BoundaryCondition right,
+        const T *lower,
+        const T *diag,
+        const T *upper
+    )
+    {
+        num_points = n;
+        left_bc = left;
+        right_bc = right;
+        f.resize(n);
+        inv_b.resize(n);
+        c.resize(n);
+        for(std::size_t i = 0; i < n; i++)
+        {
+            f[i] = lower[i];
+            inv_b[i] = diag[i];
+            c[i] = upper[i];
+        }
+        // end conditions are part of the matrix
+        left_not_a_knot = false;
+        right_not_a_knot = false;
+        factorize();
+    }
+
+    template<typename T, std::size_t N>
+    void Factorization<T, N>::factorize()
+    {
+        // a is stored in f and b in inv_b
+        const std::size_t n = num_points;
+        StorageType<T, N> &a = f;
+        StorageType<T, N> &b = inv_b;
+
+        // Perturbed problem?
+        is_perturbed = a[0] != 0 || c[n-1] != 0;
+        vn = 0.0;
+        if(is_perturbed)
+        {
+            // Modify problem
+            q.resize(n);
+            for(std::size_t i = 1; i < n; i++) q[i] = 0.0;
+            vn = a[0]/b[0];
+            q[0] = -b[0];
+            q[n-1] = c[n-1];
+            a[0] = 0;
+            b[0] = 2*b[0];
+            b[n-1] = b[n-1] + c[n-1]*vn;
+            c[n-1] = 0;
+        }
+
+        // Forward elimination
+        // i = 1 ... n:
+        f[0] = 0.0;
+        for(std::size_t i = 1; i < n; i++)
+        {
+            f[i] = a[i]/b[i-1];
+            b[i] = b[i] - f[i]*c[i-1];
+            if(is_perturbed) q[i] = q[i] - f[i]*q[i-1];
+        }
+        for(std::size_t i = 0; i < n; i++)
+        {
+            inv_b[i] = 1.0/b[i];
+        }
+
+        if(is_perturbed)
+        {
+            // Backward substitution for q
+            q[n-1] = q[n-1]*inv_b[n-1];
+            for(std::size_t i = n-1; i-- > 0;)
+            {
+                q[i] = (q[i] - c[i]*q[i+1])*inv_b[i];
+            }
+            inv_vq = 1.0/(1.0 + q[0] - q[n-1]*vn);
+        }
+    }
+
+    /**
+     * End moments of not-a-knot boundaries
+     *
+     * The third derivative is continuous across the second and the second to
+     * last point, i.e. the end moments continue the inner ones linearly. With
+     * three points and both ends not-a-knot the spline is a parabola.
+     */
+    template<typename T>
+    inline void extrapolate_not_a_knot(
+        const bool left,
+        const bool right,
+        const std::size_t n,
+        const std::size_t num_dims,
+        const std::size_t stride,
+        T *d
+    )
+    {
+        T *first = d;
+        T *last = d + (n-1)*stride;
+        for(std::size_t j = 0; j < num_dims; j++)
+        {
+            if(left && right && n == 3)
+            {
+                first[j] = d[stride+j];
+                last[j] = d[stride+j];
+                continue;
+            }
+            if(left) first[j] = 2.0*d[stride+j] - d[2*stride+j];
+            if(right) last[j] = 2.0*d[(n-2)*stride+j] - d[(n-3)*stride+j];
+        }
+    }
+
+    /**
+     * Shared cache of factorizations keyed on (num_points, left_bc, right_bc)
+     *
+     * Entries are immutable once inserted and handed out as shared pointers,
+     * hence lookups from multiple threads only contend on the map access.
+     */
+    template<typename T, std::size_t N>
+    class FactorizationCache
+    {
+        typedef std::tuple<std::size_t, BoundaryCondition, BoundaryCondition> Key;
+
+        std::mutex mutex_;
+        std::map<Key, std::shared_ptr<const Factorization<T, N>>> entries_;
+
+        static FactorizationCache& instance()
+        {
+            static FactorizationCache cache;
+            return cache;
+        }
+
+    public:
+        static std::shared_ptr<const Factorization<T, N>> get(
+            const std::size_t num_points,
+            const BoundaryCondition left_bc,
+            const BoundaryCondition right_bc
+        )
+        {
+            FactorizationCache &cache = instance();
+            Key key(num_points, left_bc, right_bc);
+            {
+                std::lock_guard<std::mutex> lock(cache.mutex_);
+                auto it = cache.entries_.find(key);
+                if(it != cache.entries_.end()) return it->second;
+            }
+
+            // Factorize outside of the lock, concurrent misses on the same key
+            // keep whichever entry was inserted first
+            auto factorization = std::make_shared<Factorization<T, N>>();
+            factorization->compute(num_points, left_bc, right_bc);
+            std::lock_guard<std::mutex> lock(cache.mutex_);
+            return cache.entries_.emplace(key, std::move(factorization)).first->second;
+        }
+
+        static void clear()
+        {
+            FactorizationCache &cache = instance();
+            std::lock_guard<std::mutex> lock(cache.mutex_);
+            cache.entries_.clear();
+        }
+    };
+
+} // namespace: internal
+
+} // namespace: parametric_cubic_spline
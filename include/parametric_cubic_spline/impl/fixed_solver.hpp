@@ -0,0 +1,341 @@
+/*
+ * MIT License
+ *
+ * Parametric Cubic Spline Library
+ * Copyright (c) 2021-, Michael Heidingsfeld
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#pragma once
+
+#include <cstddef>
+#include <type_traits>
+
+namespace parametric_cubic_spline {
+
+namespace internal {
+
+    /**
+     * Largest number of points solved by the unrolled fixed-size solver
+     */
+    static const std::size_t max_unrolled_points = 32;
+
+    /**
+     * Factorization of the moment system as a literal type
+     *
+     * Same contents as Factorization, computed by a constexpr function such
+     * that the solver below sees all multipliers as compile-time constants.
+     */
+    template<typename T, std::size_t N>
+    struct FixedFactorization
+    {
+        bool is_perturbed;
+        bool left_not_a_knot;
+        bool right_not_a_knot;
+        T f[N];
+        T inv_b[N];
+        T c[N];
+        T q[N];
+        T vn;
+        T inv_vq;
+    };
+
+    template<typename T, std::size_t N>
+    constexpr FixedFactorization<T, N> make_fixed_factorization(
+        const BoundaryCondition left_bc,
+        const BoundaryCondition right_bc
+    )
+    {
+        FixedFactorization<T, N> result{};
+        T a[N] = {};
+        T b[N] = {};
+        T *c = result.c;
+        T *q = result.q;
+        for(std::size_t i = 0; i < N; i++)
+        {
+            moment_row(N, left_bc, right_bc, i, a[i], b[i], c[i]);
+        }
+        result.left_not_a_knot = N > 2 && left_bc == BoundaryCondition::NotAKnot;
+        result.right_not_a_knot = N > 2 && right_bc == BoundaryCondition::NotAKnot;
+
+        // Perturbed problem, see Factorization::compute()
+        result.is_perturbed = a[0] != 0 || c[N-1] != 0;
+        if(result.is_perturbed)
+        {
+            result.vn = a[0]/b[0];
+            q[0] = -b[0];
+            q[N-1] = c[N-1];
+            a[0] = 0;
+            b[0] = 2*b[0];
+            b[N-1] = b[N-1] + c[N-1]*result.vn;
+            c[N-1] = 0;
+        }
+
+        // Forward elimination
+        for(std::size_t i = 1; i < N; i++)
+        {
+            result.f[i] = a[i]/b[i-1];
+            b[i] = b[i] - result.f[i]*c[i-1];
+            if(result.is_perturbed) q[i] = q[i] - result.f[i]*q[i-1];
+        }
+        for(std::size_t i = 0; i < N; i++)
+        {
+            result.inv_b[i] = 1.0/b[i];
+        }
+
+        if(result.is_perturbed)
+        {
+            q[N-1] = q[N-1]*result.inv_b[N-1];
+            for(std::size_t i = N-1; i-- > 0;)
+            {
+                q[i] = (q[i] - c[i]*q[i+1])*result.inv_b[i];
+            }
+            result.inv_vq = 1.0/(1.0 + q[0] - q[N-1]*result.vn);
+        }
+        return result;
+    }
+
+    /**
+     * Compile-time factorization per size and boundary conditions
+     */
+    template<typename T, std::size_t N, BoundaryCondition Left, BoundaryCondition Right>
+    struct FixedFactorizationTable
+    {
+        static constexpr FixedFactorization<T, N> value = make_fixed_factorization<T, N>(Left, Right);
+    };
+
+    template<typename T, std::size_t N, BoundaryCondition Left, BoundaryCondition Right>
+    constexpr FixedFactorization<T, N> FixedFactorizationTable<T, N, Left, Right>::value;
+
+    /**
+     * Calls fn(std::integral_constant<std::size_t, I>) for I in [Begin, End)
+     */
+    template<std::size_t Begin, std::size_t End>
+    struct Unroll
+    {
+        template<typename F>
+        static inline void forward(F &fn)
+        {
+            fn(std::integral_constant<std::size_t, Begin>());
+            Unroll<Begin+1, End>::forward(fn);
+        }
+
+        template<typename F>
+        static inline void backward(F &fn)
+        {
+            Unroll<Begin+1, End>::backward(fn);
+            fn(std::integral_constant<std::size_t, Begin>());
+        }
+    };
+
+    template<std::size_t End>
+    struct Unroll<End, End>
+    {
+        template<typename F>
+        static inline void forward(F &) {}
+
+        template<typename F>
+        static inline void backward(F &) {}
+    };
+
+    /**
+     * Solver for fixed number of points, dimensions and boundary conditions
+     *
+     * Assembly and both substitution sweeps are unrolled over the points and
+     * read the factorization from compile-time constants, which reduces the
+     * solve to straight-line multiply-adds without boundary or perturbation
+     * branches.
+     */
+    template<typename T, std::size_t N, std::size_t D, BoundaryCondition Left, BoundaryCondition Right>
+    struct UnrolledSolver
+    {
+        static inline void solve(
+            const T *p,
+            const T *left_tangent,
+            const T *right_tangent,
+            T *m
+        )
+        {
+            typedef FixedFactorizationTable<T, N, Left, Right> Table;
+
+            // Right-hand side
+            for(std::size_t j = 0; j < D; j++)
+            {
+                if(Left == BoundaryCondition::Hermite)
+                    m[j] = 6.0*((p[D+j] - p[j]) - (left_tangent ? left_tangent[j] : T(0.0)));
+                else if(Left == BoundaryCondition::Periodic)
+                    m[j] = 6.0*((p[D+j] - p[j]) - (p[j] - p[(N-1)*D+j]));
+                else
+                    m[j] = 0.0;
+
+                if(Right == BoundaryCondition::Hermite)
+                    m[(N-1)*D+j] = 6.0*((right_tangent ? right_tangent[j] : T(0.0)) - (p[(N-1)*D+j] - p[(N-2)*D+j]));
+                else if(Right == BoundaryCondition::Periodic)
+                    m[(N-1)*D+j] = 6.0*((p[j] - p[(N-1)*D+j]) - (p[(N-1)*D+j] - p[(N-2)*D+j]));
+                else
+                    m[(N-1)*D+j] = 0.0;
+            }
+            auto assemble = [&](auto index)
+            {
+                const std::size_t i = decltype(index)::value;
+                for(std::size_t j = 0; j < D; j++)
+                {
+                    m[i*D+j] = 6.0*((p[(i+1)*D+j] - p[i*D+j]) - (p[i*D+j] - p[(i-1)*D+j]));
+                }
+            };
+            Unroll<1, N-1>::forward(assemble);
+
+            // Forward elimination
+            auto eliminate = [&](auto index)
+            {
+                const std::size_t i = decltype(index)::value;
+                const T f = Table::value.f[i];
+                for(std::size_t j = 0; j < D; j++)
+                {
+                    m[i*D+j] = m[i*D+j] - f*m[(i-1)*D+j];
+                }
+            };
+            Unroll<1, N>::forward(eliminate);
+
+            // Backward substitution
+            for(std::size_t j = 0; j < D; j++)
+            {
+                m[(N-1)*D+j] = m[(N-1)*D+j]*Table::value.inv_b[N-1];
+            }
+            auto substitute = [&](auto index)
+            {
+                const std::size_t i = decltype(index)::value;
+                const T c = Table::value.c[i];
+                const T inv_b = Table::value.inv_b[i];
+                for(std::size_t j = 0; j < D; j++)
+                {
+                    m[i*D+j] = (m[i*D+j] - c*m[(i+1)*D+j])*inv_b;
+                }
+            };
+            Unroll<0, N-1>::backward(substitute);
+
+            // Reconstruct solution of the perturbed problem
+            if(Table::value.is_perturbed)
+            {
+                T k[D];
+                for(std::size_t j = 0; j < D; j++)
+                {
+                    k[j] = (m[j] - m[(N-1)*D+j]*Table::value.vn)*Table::value.inv_vq;
+                }
+                auto correct = [&](auto index)
+                {
+                    const std::size_t i = decltype(index)::value;
+                    const T q = Table::value.q[i];
+                    for(std::size_t j = 0; j < D; j++)
+                    {
+                        m[i*D+j] = m[i*D+j] - k[j]*q;
+                    }
+                };
+                Unroll<0, N>::forward(correct);
+            }
+
+            if(Table::value.left_not_a_knot || Table::value.right_not_a_knot)
+            {
+                extrapolate_not_a_knot(Table::value.left_not_a_knot, Table::value.right_not_a_knot, N, D, D, m);
+            }
+        }
+    };
+
+    /**
+     * Dispatch of runtime boundary conditions onto the unrolled solvers
+     *
+     * Enabled for fixed number of points up to max_unrolled_points and fixed
+     * number of dimensions, the generic version solves nothing.
+     */
+    template<typename T, std::size_t N, std::size_t D,
+        bool Enabled = (N > 1 && N <= max_unrolled_points && D > 0)>
+    struct FixedSolver
+    {
+        static const bool enabled = false;
+
+        static inline void solve(
+            const T *, const BoundaryCondition, const BoundaryCondition, const T *, const T *, T *)
+        {
+        }
+    };
+
+    template<typename T, std::size_t N, std::size_t D>
+    struct FixedSolver<T, N, D, true>
+    {
+        static const bool enabled = true;
+
+        static inline void solve(
+            const T *points,
+            const BoundaryCondition left_bc,
+            const BoundaryCondition right_bc,
+            const T *left_tangent,
+            const T *right_tangent,
+            T *m
+        )
+        {
+            switch(left_bc)
+            {
+            case BoundaryCondition::Hermite:
+                solve<BoundaryCondition::Hermite>(points, right_bc, left_tangent, right_tangent, m);
+                break;
+            case BoundaryCondition::Periodic:
+                solve<BoundaryCondition::Periodic>(points, right_bc, left_tangent, right_tangent, m);
+                break;
+            case BoundaryCondition::NotAKnot:
+                solve<BoundaryCondition::NotAKnot>(points, right_bc, left_tangent, right_tangent, m);
+                break;
+            default: // BoundaryCondition::Natural
+                solve<BoundaryCondition::Natural>(points, right_bc, left_tangent, right_tangent, m);
+            }
+        }
+
+    private:
+        template<BoundaryCondition Left>
+        static inline void solve(
+            const T *points,
+            const BoundaryCondition right_bc,
+            const T *left_tangent,
+            const T *right_tangent,
+            T *m
+        )
+        {
+            switch(right_bc)
+            {
+            case BoundaryCondition::Hermite:
+                UnrolledSolver<T, N, D, Left, BoundaryCondition::Hermite>::solve(
+                    points, left_tangent, right_tangent, m);
+                break;
+            case BoundaryCondition::Periodic:
+                UnrolledSolver<T, N, D, Left, BoundaryCondition::Periodic>::solve(
+                    points, left_tangent, right_tangent, m);
+                break;
+            case BoundaryCondition::NotAKnot:
+                UnrolledSolver<T, N, D, Left, BoundaryCondition::NotAKnot>::solve(
+                    points, left_tangent, right_tangent, m);
+                break;
+            default: // BoundaryCondition::Natural
+                UnrolledSolver<T, N, D, Left, BoundaryCondition::Natural>::solve(
+                    points, left_tangent, right_tangent, m);
+            }
+        }
+    };
+
+} // namespace: internal
+
+} // namespace: parametric_cubic_spline
@@ -0,0 +1,277 @@
+/*
+ * MIT License
+ *
+ * Parametric Cubic Spline Library
+ * Copyright (c) 2021-, Michael Heidingsfeld
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#pragma once
+
+#include <algorithm>
+#include <type_traits>
+
+namespace parametric_cubic_spline {
+
+template<typename T, std::size_t NumPoints, std::size_t NumDims, typename Layout>
+IncrementalSolver<T, NumPoints, NumDims, Layout>::IncrementalSolver() :
+    spline_(nullptr),
+    points_(nullptr),
+    num_points_(0),
+    num_dims_(0),
+    left_bc_(BoundaryCondition::Natural),
+    right_bc_(BoundaryCondition::Natural),
+    left_tangent_(nullptr),
+    right_tangent_(nullptr),
+    active_factorization_(nullptr),
+    use_coefficients_(false),
+    phase_(Phase::Idle),
+    row_(0)
+{
+    static_assert(std::is_floating_point<T>::value, "T must be a floating point type.");
+}
+
+template<typename T, std::size_t NumPoints, std::size_t NumDims, typename Layout>
+void IncrementalSolver<T, NumPoints, NumDims, Layout>::begin(
+    SplineType &spline,
+    const T *points,
+    const std::size_t num_points,
+    const std::size_t num_dims,
+    const BoundaryCondition left_bc,
+    const BoundaryCondition right_bc,
+    const T *left_tangent,
+    const T *right_tangent
+)
+{
+    spline_ = &spline;
+    points_ = points;
+    num_points_ = num_points;
+    num_dims_ = num_dims;
+    left_bc_ = left_bc;
+    right_bc_ = right_bc;
+
+    // Tangents are only read while assembling, keep a copy anyway such that
+    // the caller does not have to hold them across steps
+    tangents_.assign(2*num_dims, T(0.0));
+    if(left_tangent) std::copy(left_tangent, left_tangent + num_dims, tangents_.begin());
+    if(right_tangent) std::copy(right_tangent, right_tangent + num_dims, tangents_.begin() + num_dims);
+    left_tangent_ = left_tangent ? tangents_.data() : nullptr;
+    right_tangent_ = right_tangent ? tangents_.data() + num_dims : nullptr;
+
+    if(spline.use_factorization_cache_)
+    {
+        if(!shared_factorization_ || !shared_factorization_->matches(num_points, left_bc, right_bc))
+        {
+            shared_factorization_ = internal::FactorizationCache<T, NumPoints>::get(num_points, left_bc, right_bc);
+        }
+        active_factorization_ = shared_factorization_.get();
+    }
+    else
+    {
+        if(!factorization_.matches(num_points, left_bc, right_bc))
+        {
+            factorization_.compute(num_points, left_bc, right_bc);
+        }
+        active_factorization_ = &factorization_;
+    }
+
+    const std::size_t padded_dims = internal::LayoutTraits<Layout>::padded_dims(num_dims);
+    use_coefficients_ = spline.use_coefficient_cache_;
+    if(NumPoints == Dynamic || NumDims == Dynamic)
+    {
+        moments_.resize(num_points*padded_dims);
+    }
+    if(use_coefficients_) coefficients_.resize(4*(num_points - 1)*padded_dims);
+
+    phase_ = Phase::Assemble;
+    row_ = 0;
+}
+
+template<typename T, std::size_t NumPoints, std::size_t NumDims, typename Layout>
+bool IncrementalSolver<T, NumPoints, NumDims, Layout>::step(const std::size_t max_rows)
+{
+    for(std::size_t k = 0; k < max_rows && phase_ != Phase::Idle; k++)
+    {
+        process_row();
+    }
+    return phase_ == Phase::Idle;
+}
+
+template<typename T, std::size_t NumPoints, std::size_t NumDims, typename Layout>
+bool IncrementalSolver<T, NumPoints, NumDims, Layout>::is_running() const
+{
+    return phase_ != Phase::Idle;
+}
+
+template<typename T, std::size_t NumPoints, std::size_t NumDims, typename Layout>
+void IncrementalSolver<T, NumPoints, NumDims, Layout>::process_row()
+{
+    // One row of every block of the layout per call, with the same
+    // arithmetic as Spline::tdma() on a block
+    const std::size_t n = num_points_;
+    const std::size_t width = internal::LayoutTraits<Layout>::block_width(num_dims_);
+    const std::size_t num_blocks = internal::LayoutTraits<Layout>::padded_dims(num_dims_)/width;
+    const internal::Factorization<T, NumPoints> &factorization = *active_factorization_;
+    T *m = moments_.data();
+
+    switch(phase_)
+    {
+    case Phase::Assemble:
+        for(std::size_t b = 0; b < num_blocks; b++)
+        {
+            SplineType::assemble_block(m, n, num_dims_, width, b, 0, width, row_, row_ + 1,
+                points_, left_bc_, right_bc_, left_tangent_, right_tangent_);
+        }
+        if(++row_ == n) finish_phase();
+        break;
+    case Phase::Eliminate:
+        for(std::size_t b = 0; b < num_blocks; b++)
+        {
+            T *block = m + b*n*width;
+            internal::SweepKernel<T>::eliminate(block + row_*width, block + (row_-1)*width,
+                factorization.f[row_], width);
+        }
+        if(++row_ == n) finish_phase();
+        break;
+    case Phase::Substitute:
+        // counts down, row_ is one past the row to substitute
+        for(std::size_t b = 0; b < num_blocks; b++)
+        {
+            T *block = m + b*n*width;
+            const std::size_t i = row_ - 1;
+            if(i == n - 1)
+            {
+                for(std::size_t j = 0; j < width; j++)
+                {
+                    block[i*width+j] = block[i*width+j]*factorization.inv_b[i];
+                }
+            }
+            else
+            {
+                internal::SweepKernel<T>::substitute(block + i*width, block + (i+1)*width,
+                    factorization.c[i], factorization.inv_b[i], width);
+            }
+        }
+        if(--row_ == 0) finish_phase();
+        break;
+    case Phase::Correct:
+        // inner rows first, first and last row together in the final step
+        for(std::size_t b = 0; b < num_blocks; b++)
+        {
+            T *block = m + b*n*width;
+            const T *first = block;
+            const T *last = block + (n-1)*width;
+            for(std::size_t j = 0; j < width; j++)
+            {
+                T k = (first[j] - last[j]*factorization.vn)*factorization.inv_vq;
+                if(row_ < n - 1)
+                {
+                    block[row_*width+j] = block[row_*width+j] - k*factorization.q[row_];
+                }
+                else
+                {
+                    block[j] = block[j] - k*factorization.q[0];
+                    block[(n-1)*width+j] = block[(n-1)*width+j] - k*factorization.q[n-1];
+                }
+            }
+        }
+        if(row_++ == n - 1) finish_phase();
+        break;
+    case Phase::Coefficients:
+        for(std::size_t j = 0; j < num_dims_; j++)
+        {
+            SplineType::power_basis(points_[row_*num_dims_+j], points_[(row_+1)*num_dims_+j],
+                m[internal::LayoutTraits<Layout>::index(row_, j, n, num_dims_)],
+                m[internal::LayoutTraits<Layout>::index(row_+1, j, n, num_dims_)],
+                &coefficients_[4*internal::LayoutTraits<Layout>::index(row_, j, n-1, num_dims_)]);
+        }
+        if(++row_ == n - 1) finish_phase();
+        break;
+    default:
+        break;
+    }
+}
+
+template<typename T, std::size_t NumPoints, std::size_t NumDims, typename Layout>
+void IncrementalSolver<T, NumPoints, NumDims, Layout>::finish_phase()
+{
+    switch(phase_)
+    {
+    case Phase::Assemble:
+        phase_ = Phase::Eliminate;
+        row_ = 1;
+        break;
+    case Phase::Eliminate:
+        phase_ = Phase::Substitute;
+        row_ = num_points_;
+        break;
+    case Phase::Substitute:
+        if(active_factorization_->is_perturbed)
+        {
+            phase_ = Phase::Correct;
+            row_ = 1;
+            break;
+        }
+        // fall through
+    case Phase::Correct:
+    {
+        // not-a-knot end moments, a few rows per column
+        const std::size_t width = internal::LayoutTraits<Layout>::block_width(num_dims_);
+        const std::size_t num_blocks = internal::LayoutTraits<Layout>::padded_dims(num_dims_)/width;
+        for(std::size_t b = 0; b < num_blocks; b++)
+        {
+            internal::extrapolate_not_a_knot(active_factorization_->left_not_a_knot,
+                active_factorization_->right_not_a_knot, num_points_, width, width,
+                moments_.data() + b*num_points_*width);
+        }
+        if(use_coefficients_)
+        {
+            phase_ = Phase::Coefficients;
+            row_ = 0;
+            break;
+        }
+    }
+        // fall through
+    default:
+        publish();
+    }
+}
+
+template<typename T, std::size_t NumPoints, std::size_t NumDims, typename Layout>
+void IncrementalSolver<T, NumPoints, NumDims, Layout>::publish()
+{
+    // Invalidates cursors like set()
+    SplineType &spline = *spline_;
+    spline.version_++;
+    spline.num_points_ = num_points_;
+    spline.num_dims_ = num_dims_;
+    spline.points_ = points_;
+    spline.left_bc_ = left_bc_;
+    spline.right_bc_ = right_bc_;
+    spline.moments_.swap(moments_);
+    if(spline.use_coefficient_cache_)
+    {
+        // cache enabled during the solve, expand at once
+        if(use_coefficients_) spline.coefficients_.swap(coefficients_);
+        else spline.compute_coefficients();
+    }
+    phase_ = Phase::Idle;
+}
+
+} // namespace: parametric_cubic_spline
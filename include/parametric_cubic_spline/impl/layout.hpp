@@ -0,0 +1,89 @@
+/*
+ * MIT License
+ *
+ * Parametric Cubic Spline Library
+ * Copyright (c) 2021-, Michael Heidingsfeld
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#pragma once
+
+#include <cstddef>
+
+namespace parametric_cubic_spline {
+
+namespace internal {
+
+    /**
+     * Index mapping of a storage layout
+     *
+     * All layouts split the dimensions into blocks of block_width() columns.
+     * Within a block, the rows are stored one after another with the columns
+     * of a row contiguous, hence a block can be solved like an interleaved
+     * system of block_width() dimensions. AoS is a single block, SoA one
+     * block per dimension. Dimensions are padded to a multiple of the block
+     * width.
+     */
+    template<typename Layout>
+    struct LayoutTraits;
+
+    template<>
+    struct LayoutTraits<layout::AoS>
+    {
+        static constexpr std::size_t padded_dims(const std::size_t num_dims) { return num_dims; }
+        static inline std::size_t block_width(const std::size_t num_dims) { return num_dims; }
+        static inline std::size_t index(
+            const std::size_t i, const std::size_t j, const std::size_t, const std::size_t num_dims)
+        {
+            return i*num_dims + j;
+        }
+    };
+
+    template<>
+    struct LayoutTraits<layout::SoA>
+    {
+        static constexpr std::size_t padded_dims(const std::size_t num_dims) { return num_dims; }
+        static inline std::size_t block_width(const std::size_t) { return 1; }
+        static inline std::size_t index(
+            const std::size_t i, const std::size_t j, const std::size_t num_rows, const std::size_t)
+        {
+            return j*num_rows + i;
+        }
+    };
+
+    template<std::size_t Width>
+    struct LayoutTraits<layout::AoSoA<Width>>
+    {
+        static_assert(Width > 0, "Block width of 'AoSoA' must be greater than zero.");
+
+        static constexpr std::size_t padded_dims(const std::size_t num_dims)
+        {
+            return (num_dims + Width - 1)/Width*Width;
+        }
+        static inline std::size_t block_width(const std::size_t) { return Width; }
+        static inline std::size_t index(
+            const std::size_t i, const std::size_t j, const std::size_t num_rows, const std::size_t)
+        {
+            return (j/Width)*num_rows*Width + i*Width + j%Width;
+        }
+    };
+
+} // namespace: internal
+
+} // namespace: parametric_cubic_spline
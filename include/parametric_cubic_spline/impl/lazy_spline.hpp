@@ -0,0 +1,210 @@
+/*
+ * MIT License
+ *
+ * Parametric Cubic Spline Library
+ * Copyright (c) 2021-, Michael Heidingsfeld
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <type_traits>
+
+namespace parametric_cubic_spline {
+
+template<typename T>
+LazySpline<T>::LazySpline() :
+    num_points_(0),
+    num_dims_(0),
+    points_(nullptr),
+    window_(0)
+{
+    static_assert(std::is_floating_point<T>::value, "T must be a floating point type.");
+
+    // The inverse of the bi-infinite tridiag(1, 4, 1) has the entries
+    // (-r)^|k-l|/(2 sqrt(3)) with r = 2 - sqrt(3), entries beyond the window
+    // are below machine precision
+    const T r = 2.0 - std::sqrt(3.0);
+    window_ = static_cast<std::size_t>(std::ceil(
+        std::log(std::numeric_limits<T>::epsilon())/std::log(r))) + 1;
+    inverse_.resize(window_ + 1);
+    inverse_[0] = 1.0/(2.0*std::sqrt(3.0));
+    for(std::size_t e = 1; e <= window_; e++)
+    {
+        inverse_[e] = -r*inverse_[e-1];
+    }
+}
+
+template<typename T>
+void LazySpline<T>::set(
+    const T *points,
+    const std::size_t num_points,
+    const std::size_t num_dims
+)
+{
+    num_points_ = num_points;
+    num_dims_ = num_dims;
+    points_ = points;
+    segments_.clear();
+    coefficients_.clear();
+
+    // Short splines, the images of both ends do not vanish
+    if(num_points_ <= 2*window_ + 1)
+    {
+        const std::size_t n = num_points_;
+        moments_.resize(n*num_dims_);
+        Spline<T, Dynamic, Dynamic>::assemble_rhs(points_, n, num_dims_,
+            BoundaryCondition::Natural, BoundaryCondition::Natural, nullptr, nullptr,
+            0, n, 0, num_dims_, moments_.data(), num_dims_);
+        if(!factorization_.matches(n, BoundaryCondition::Natural, BoundaryCondition::Natural))
+        {
+            factorization_.compute(n, BoundaryCondition::Natural, BoundaryCondition::Natural);
+        }
+        Spline<T, Dynamic, Dynamic>::tdma(n, num_dims_, num_dims_, factorization_, moments_.data());
+    }
+    else
+    {
+        moments_.clear();
+    }
+}
+
+template<typename T>
+void LazySpline<T>::moment(
+    const std::size_t k,
+    T *m
+) const
+{
+    // Natural ends, M_0 = M_n-1 = 0
+    const std::size_t n = num_points_;
+    const std::size_t num_dims = num_dims_;
+    std::fill(m, m + num_dims, T(0.0));
+    if(k == 0 || k == n - 1) return;
+
+    // Rows 1 ... n-2 with zero moments at 0 and n-1 act like mirrors, the
+    // inverse of the finite matrix is the bi-infinite one minus its images
+    // at -l and 2(n-1)-l, further images are below machine precision
+    const std::size_t begin = k > window_ ? k - window_ : 1;
+    const std::size_t end = std::min(n - 2, k + window_);
+    for(std::size_t l = begin; l <= end; l++)
+    {
+        T g = inverse_[k > l ? k - l : l - k];
+        if(k + l <= window_) g -= inverse_[k + l];
+        if(2*(n-1) - k - l <= window_) g -= inverse_[2*(n-1) - k - l];
+        const T *p = &points_[l*num_dims];
+        for(std::size_t j = 0; j < num_dims; j++)
+        {
+            m[j] += g*6.0*((p[num_dims+j] - p[j]) - (p[j] - (p - num_dims)[j]));
+        }
+    }
+}
+
+template<typename T>
+const T* LazySpline<T>::segment(const std::size_t i)
+{
+    auto it = segments_.find(i);
+    if(it != segments_.end()) return &coefficients_[it->second];
+
+    // Moments from the full solve or from the window around the segment, kept
+    // behind the coefficients until they are expanded
+    const std::size_t num_dims = num_dims_;
+    const std::size_t offset = coefficients_.size();
+    coefficients_.resize(offset + 6*num_dims);
+    T *m0 = &coefficients_[offset + 4*num_dims];
+    T *m1 = m0 + num_dims;
+    if(!moments_.empty())
+    {
+        std::copy(moments_.data() + i*num_dims, moments_.data() + (i+2)*num_dims, m0);
+    }
+    else
+    {
+        moment(i, m0);
+        moment(i+1, m1);
+    }
+    for(std::size_t j = 0; j < num_dims; j++)
+    {
+        Spline<T, Dynamic, Dynamic>::power_basis(points_[i*num_dims+j], points_[(i+1)*num_dims+j],
+            m0[j], m1[j], &coefficients_[offset + 4*j]);
+    }
+    coefficients_.resize(offset + 4*num_dims);
+    segments_.emplace(i, offset);
+    return &coefficients_[offset];
+}
+
+template<typename T>
+void LazySpline<T>::eval(
+    const T pos,
+    T *out_point
+)
+{
+    // Positions outside of [0, 1] are extrapolated from the first or last
+    // segment
+    const std::size_t num_segments = num_points_ - 1;
+    const T s = pos*num_segments;
+    std::size_t i = s > 0 ? static_cast<std::size_t>(s) : 0;
+    if(i > num_segments - 1) i = num_segments - 1;
+    const T t = s - i;
+
+    const T *coeffs = segment(i);
+    for(std::size_t j = 0; j < num_dims_; j++, coeffs += 4)
+    {
+        *out_point++ = ((coeffs[3]*t + coeffs[2])*t + coeffs[1])*t + coeffs[0];
+    }
+}
+
+template<typename T>
+void LazySpline<T>::eval(
+    const T *pos,
+    const std::size_t num_pos,
+    T *out_points
+)
+{
+    for(std::size_t k = 0; k < num_pos; k++)
+    {
+        eval(pos[k], &out_points[k*num_dims_]);
+    }
+}
+
+template<typename T>
+std::size_t LazySpline<T>::num_points() const
+{
+    return num_points_;
+}
+
+template<typename T>
+std::size_t LazySpline<T>::num_dims() const
+{
+    return num_dims_;
+}
+
+template<typename T>
+std::size_t LazySpline<T>::num_computed_segments() const
+{
+    return segments_.size();
+}
+
+template<typename T>
+std::size_t LazySpline<T>::window() const
+{
+    return window_;
+}
+
+} // namespace: parametric_cubic_spline
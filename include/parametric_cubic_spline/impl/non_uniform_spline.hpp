@@ -0,0 +1,401 @@
+/*
+ * MIT License
+ *
+ * Parametric Cubic Spline Library
+ * Copyright (c) 2021-, Michael Heidingsfeld
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <type_traits>
+
+namespace parametric_cubic_spline {
+
+template<typename T>
+NonUniformSpline<T>::NonUniformSpline() :
+    num_points_(0),
+    num_dims_(0)
+{
+    static_assert(std::is_floating_point<T>::value, "T must be a floating point type.");
+}
+
+template<typename T>
+void NonUniformSpline<T>::set(
+    const T *points,
+    const std::size_t num_points,
+    const std::size_t num_dims,
+    const Parameterization parameterization,
+    const BoundaryCondition left_bc,
+    const BoundaryCondition right_bc,
+    const T *left_tangent,
+    const T *right_tangent
+)
+{
+    num_dims_ = num_dims;
+
+    // Spacing between two points
+    auto spacing = [&](const T *a, const T *b)
+    {
+        if(parameterization == Parameterization::Uniform) return T(1.0);
+        T distance = 0.0;
+        for(std::size_t j = 0; j < num_dims; j++)
+        {
+            const T delta = b[j] - a[j];
+            distance += delta*delta;
+        }
+        distance = std::sqrt(distance);
+        return parameterization == Parameterization::Centripetal ? std::sqrt(distance) : distance;
+    };
+    auto point = [&](const std::size_t i) { return points + i*num_dims; };
+
+    // Coincident consecutive points have no spacing and are merged into one,
+    // as is a periodic end point repeating the first one
+    const bool is_periodic = left_bc == BoundaryCondition::Periodic;
+    bool has_duplicates = is_periodic && spacing(point(num_points-1), point(0)) == 0;
+    for(std::size_t i = 0; i + 1 < num_points && !has_duplicates; i++)
+    {
+        has_duplicates = spacing(point(i), point(i+1)) == 0;
+    }
+    const T *p = points;
+    std::size_t n = num_points;
+    if(has_duplicates)
+    {
+        merged_.assign(point(0), point(1));
+        for(std::size_t i = 1; i < num_points; i++)
+        {
+            if(spacing(&merged_[merged_.size() - num_dims], point(i)) > 0)
+            {
+                merged_.insert(merged_.end(), point(i), point(i+1));
+            }
+        }
+        if(is_periodic && merged_.size() > num_dims &&
+            spacing(&merged_[merged_.size() - num_dims], point(0)) == 0)
+        {
+            merged_.resize(merged_.size() - num_dims);
+        }
+        p = merged_.data();
+        n = merged_.size()/num_dims;
+    }
+    assert(n >= 2 && "at least two distinct points are required");
+    num_points_ = n;
+
+    knots_.resize(n);
+    knots_[0] = 0.0;
+    for(std::size_t i = 0; i + 1 < n; i++)
+    {
+        knots_[i+1] = knots_[i] + spacing(p + i*num_dims, p + (i+1)*num_dims);
+    }
+    const T length = knots_[n-1];
+    assert(length > 0);
+    for(std::size_t i = 1; i + 1 < n; i++) knots_[i] /= length;
+    knots_[n-1] = 1.0;
+    const T closing = is_periodic ? spacing(p + (n-1)*num_dims, p)/length : T(0.0);
+
+    solve(p, left_bc, right_bc, left_tangent, right_tangent, closing);
+}
+
+template<typename T>
+void NonUniformSpline<T>::set(
+    const T *points,
+    const std::size_t num_points,
+    const std::size_t num_dims,
+    const T *knots,
+    const BoundaryCondition left_bc,
+    const BoundaryCondition right_bc,
+    const T *left_tangent,
+    const T *right_tangent
+)
+{
+    num_points_ = num_points;
+    num_dims_ = num_dims;
+
+    const T length = knots[num_points-1] - knots[0];
+    assert(length > 0);
+    for(std::size_t i = 0; i + 1 < num_points; i++)
+    {
+        assert(knots[i+1] > knots[i] && "knots must be strictly increasing");
+    }
+    if(left_bc == BoundaryCondition::Periodic) assert(knots[num_points] > knots[num_points-1]);
+    knots_.resize(num_points);
+    for(std::size_t i = 0; i < num_points; i++) knots_[i] = (knots[i] - knots[0])/length;
+    knots_[num_points-1] = 1.0;
+    const T closing = left_bc == BoundaryCondition::Periodic
+        ? (knots[num_points] - knots[num_points-1])/length : T(0.0);
+
+    solve(points, left_bc, right_bc, left_tangent, right_tangent, closing);
+}
+
+template<typename T>
+void NonUniformSpline<T>::solve(
+    const T *points,
+    const BoundaryCondition left_bc,
+    const BoundaryCondition right_bc,
+    const T *left_tangent,
+    const T *right_tangent,
+    const T closing_interval
+)
+{
+    const std::size_t n = num_points_;
+    const std::size_t num_dims = num_dims_;
+    const T *p = points;
+
+    // Workspace: the three diagonals followed by the right-hand side
+    workspace_.resize(3*n + n*num_dims);
+    T *lower = workspace_.data();
+    T *diag = lower + n;
+    T *upper = diag + n;
+    T *d = upper + n;
+    auto h = [&](const std::size_t i) { return i + 1 < n ? knots_[i+1] - knots_[i] : closing_interval; };
+    auto slope = [&](const std::size_t i, const std::size_t k, const std::size_t j)
+    {
+        return (p[k*num_dims+j] - p[i*num_dims+j])/h(i);
+    };
+
+    // Inner rows, continuity of the first derivative at knot i
+    for(std::size_t i = 1; i + 1 < n; i++)
+    {
+        lower[i] = h(i-1);
+        diag[i] = 2.0*(h(i-1) + h(i));
+        upper[i] = h(i);
+        for(std::size_t j = 0; j < num_dims; j++)
+        {
+            d[i*num_dims+j] = 6.0*(slope(i, i+1, j) - slope(i-1, i, j));
+        }
+    }
+
+    // Boundary rows, not-a-knot falls back to natural for two points
+    const bool left_not_a_knot = left_bc == BoundaryCondition::NotAKnot && n > 2;
+    const bool right_not_a_knot = right_bc == BoundaryCondition::NotAKnot && n > 2;
+    lower[0] = 0.0;
+    diag[0] = 1.0;
+    upper[0] = 0.0;
+    lower[n-1] = 0.0;
+    diag[n-1] = 1.0;
+    upper[n-1] = 0.0;
+    for(std::size_t j = 0; j < num_dims; j++)
+    {
+        d[j] = 0.0;
+        d[(n-1)*num_dims+j] = 0.0;
+    }
+    switch(left_bc)
+    {
+    case BoundaryCondition::Hermite:
+        diag[0] = 2.0*h(0);
+        upper[0] = h(0);
+        for(std::size_t j = 0; j < num_dims; j++)
+        {
+            d[j] = 6.0*(slope(0, 1, j) - (left_tangent ? left_tangent[j] : T(0.0)));
+        }
+        break;
+    case BoundaryCondition::Periodic:
+        lower[0] = closing_interval;
+        diag[0] = 2.0*(closing_interval + h(0));
+        upper[0] = h(0);
+        for(std::size_t j = 0; j < num_dims; j++)
+        {
+            d[j] = 6.0*(slope(0, 1, j) - slope(n-1, 0, j));
+        }
+        break;
+    default:
+        break;
+    }
+    switch(right_bc)
+    {
+    case BoundaryCondition::Hermite:
+        lower[n-1] = h(n-2);
+        diag[n-1] = 2.0*h(n-2);
+        for(std::size_t j = 0; j < num_dims; j++)
+        {
+            d[(n-1)*num_dims+j] = 6.0*((right_tangent ? right_tangent[j] : T(0.0)) - slope(n-2, n-1, j));
+        }
+        break;
+    case BoundaryCondition::Periodic:
+        lower[n-1] = h(n-2);
+        diag[n-1] = 2.0*(h(n-2) + closing_interval);
+        upper[n-1] = closing_interval;
+        for(std::size_t j = 0; j < num_dims; j++)
+        {
+            d[(n-1)*num_dims+j] = 6.0*(slope(n-1, 0, j) - slope(n-2, n-1, j));
+        }
+        break;
+    default:
+        break;
+    }
+
+    // Not-a-knot, M_0 = (1 + r)M_1 - rM_2 with r = h_0/h_1 substituted into
+    // row 1 keeps the system tridiagonal, likewise at the right end. Three
+    // points with both ends not-a-knot give a parabola.
+    if(left_not_a_knot && right_not_a_knot && n == 3)
+    {
+        lower[1] = 0.0;
+        diag[1] = 3.0*(h(0) + h(1));
+        upper[1] = 0.0;
+    }
+    else
+    {
+        if(left_not_a_knot)
+        {
+            const T r = h(0)/h(1);
+            lower[1] = 0.0;
+            diag[1] = 3.0*h(0) + 2.0*h(1) + h(0)*r;
+            upper[1] = h(1) - h(0)*r;
+        }
+        if(right_not_a_knot)
+        {
+            const T r = h(n-2)/h(n-3);
+            lower[n-2] = h(n-3) - h(n-2)*r;
+            diag[n-2] = 2.0*h(n-3) + 3.0*h(n-2) + h(n-2)*r;
+            upper[n-2] = 0.0;
+        }
+    }
+
+    factorization_.compute(n, left_bc, right_bc, lower, diag, upper);
+    Spline<T, Dynamic, Dynamic>::tdma(n, num_dims, num_dims, factorization_, d);
+
+    for(std::size_t j = 0; j < num_dims; j++)
+    {
+        T *m = d + j;
+        if(left_not_a_knot && right_not_a_knot && n == 3)
+        {
+            m[0] = m[num_dims];
+            m[2*num_dims] = m[num_dims];
+            continue;
+        }
+        if(left_not_a_knot)
+        {
+            const T r = h(0)/h(1);
+            m[0] = (1.0 + r)*m[num_dims] - r*m[2*num_dims];
+        }
+        if(right_not_a_knot)
+        {
+            const T r = h(n-2)/h(n-3);
+            m[(n-1)*num_dims] = (1.0 + r)*m[(n-2)*num_dims] - r*m[(n-3)*num_dims];
+        }
+    }
+
+    // Power basis in the local parameter t = (pos - knot_i)/h_i, the moments
+    // are second derivatives w.r.t. pos and scale with h_i^2
+    coefficients_.resize(4*(n-1)*num_dims);
+    for(std::size_t i = 0; i + 1 < n; i++)
+    {
+        const T h2 = h(i)*h(i);
+        for(std::size_t j = 0; j < num_dims; j++)
+        {
+            Spline<T, Dynamic, Dynamic>::power_basis(p[i*num_dims+j], p[(i+1)*num_dims+j],
+                h2*d[i*num_dims+j], h2*d[(i+1)*num_dims+j], &coefficients_[4*(i*num_dims+j)]);
+        }
+    }
+
+    build_guide();
+}
+
+template<typename T>
+void NonUniformSpline<T>::build_guide()
+{
+    // Cell k covers [k/G, (k+1)/G) with G the number of segments and holds
+    // the segment containing k/G
+    const std::size_t num_segments = num_points_ - 1;
+    guide_.resize(num_segments + 1);
+    std::size_t i = 0;
+    for(std::size_t k = 0; k <= num_segments; k++)
+    {
+        const T boundary = T(k)/num_segments;
+        while(i + 1 < num_segments && knots_[i+1] <= boundary) i++;
+        guide_[k] = i;
+    }
+}
+
+template<typename T>
+std::size_t NonUniformSpline<T>::locate(
+    const T pos,
+    T &t
+) const
+{
+    // Segments [guide_[k], guide_[k+1]] overlap cell k, positions outside
+    // of [0, 1] are extrapolated from the first or last segment
+    const std::size_t num_segments = num_points_ - 1;
+    const T s = pos*num_segments;
+    std::size_t k = s > 0 ? static_cast<std::size_t>(s) : 0;
+    if(k > num_segments - 1) k = num_segments - 1;
+    std::size_t lo = guide_[k];
+    std::size_t hi = guide_[k+1];
+    while(lo < hi)
+    {
+        const std::size_t mid = (lo + hi + 1)/2;
+        if(knots_[mid] <= pos) lo = mid;
+        else hi = mid - 1;
+    }
+    // cell boundaries and pos*G may round differently
+    while(lo > 0 && knots_[lo] > pos) lo--;
+    while(lo + 1 < num_segments && knots_[lo+1] <= pos) lo++;
+    t = (pos - knots_[lo])/(knots_[lo+1] - knots_[lo]);
+    return lo;
+}
+
+template<typename T>
+void NonUniformSpline<T>::eval(
+    const T pos,
+    T *out_point
+) const
+{
+    T t;
+    const std::size_t i = locate(pos, t);
+    const T *coeffs = &coefficients_[4*i*num_dims_];
+    for(std::size_t j = 0; j < num_dims_; j++, coeffs += 4)
+    {
+        *out_point++ = ((coeffs[3]*t + coeffs[2])*t + coeffs[1])*t + coeffs[0];
+    }
+}
+
+template<typename T>
+void NonUniformSpline<T>::eval(
+    const T *pos,
+    const std::size_t num_pos,
+    T *out_points
+) const
+{
+    for(std::size_t k = 0; k < num_pos; k++)
+    {
+        eval(pos[k], &out_points[k*num_dims_]);
+    }
+}
+
+template<typename T>
+std::size_t NonUniformSpline<T>::num_points() const
+{
+    return num_points_;
+}
+
+template<typename T>
+std::size_t NonUniformSpline<T>::num_dims() const
+{
+    return num_dims_;
+}
+
+template<typename T>
+const T *NonUniformSpline<T>::knots() const
+{
+    return knots_.data();
+}
+
+} // namespace: parametric_cubic_spline
@@ -24,56 +24,92 @@
  */
 #pragma once
 
+#include <algorithm>
 #include <cassert>
+#include <cmath>
+#include <limits>
+#include <type_traits>
+
+#include "parametric_cubic_spline/impl/storage.hpp"
+#include "parametric_cubic_spline/impl/factorization.hpp"
+#include "parametric_cubic_spline/impl/fixed_solver.hpp"
+#include "parametric_cubic_spline/impl/simd.hpp"
+#include "parametric_cubic_spline/impl/thread_pool.hpp"
 
 namespace parametric_cubic_spline {
 
 namespace internal {
 
     /**
-     * Statically allocated array
+     * Rows per chunk of the partitioned solver
+     *
+     * Fixed rather than derived from the number of threads, such that the
+     * result of the partitioned solve does not depend on the thread count.
      */
-    template<typename T, std::size_t N>
-    class StorageType
-    {
-        std::array<T, N> data_;
-    public:
-        StorageType() = default;
-        StorageType(std::size_t) { /* Do nothing */ }
-        inline void resize(std::size_t) { /* Do nothing */ }
-        inline T* data() { return data_.data(); }
-        inline T& operator[](int pos) { return data_[pos]; }
-        inline const T& operator[](int pos) const { return data_[pos]; }
-    };
+    static const std::size_t partition_size = 8192;
 
     /**
-     * Partial template specialization for dynamically allocated array
+     * Splines solved side by side in set_batch()
+     *
+     * Bounds the interleaved right-hand sides to a cache-friendly size while
+     * leaving enough columns to fill the SIMD registers.
      */
-    template<typename T>
-    class StorageType<T, Dynamic>
-    {
-        std::vector<T> data_;
-    public:
-        StorageType() = default;
-        StorageType(std::size_t size) { resize(size); }
-        inline void resize(std::size_t size) { data_ = std::vector<T>(size, 0.0); }
-        inline T* data() { return data_.data(); }
-        inline T& operator[](int pos) { return data_[pos]; }
-        inline const T& operator[](int pos) const { return data_[pos]; }
-    };
+    static const std::size_t batch_size = 32;
+
+    /**
+     * Columns per task when solving or evaluating many dimensions
+     *
+     * A multiple of every SIMD width. Wide systems are always split into
+     * chunks of this size, such that results do not depend on the thread
+     * count.
+     */
+    static const std::size_t channel_chunk = 256;
+
+    /**
+     * Contiguous dimensions from which batch evaluation runs over rows of
+     * dimensions
+     */
+    static const std::size_t channel_min_dims = 16;
+
+    /**
+     * Elements (rows times columns) below which work stays on one thread
+     */
+    static const std::size_t min_parallel_work = 1 << 16;
+
+    /**
+     * Positions per task of the batch evaluation
+     *
+     * The output of a chunk covers a multiple of 64 bytes for any number of
+     * dimensions.
+     */
+    static const std::size_t position_chunk = 1024;
+
+    /**
+     * Points below which update_point() solves the change on all rows
+     */
+    static const std::size_t min_local_update = 256;
 
 } // namespace: internal
 
 
-template<typename T, std::size_t NumPoints, std::size_t NumDims>
-Spline<T, NumPoints, NumDims>::Spline()
+template<typename T, std::size_t NumPoints, std::size_t NumDims, typename Layout>
+Spline<T, NumPoints, NumDims, Layout>::Spline() :
+    num_points_(0),
+    num_dims_(NumDims),
+    points_(nullptr),
+    left_bc_(BoundaryCondition::Natural),
+    right_bc_(BoundaryCondition::Natural),
+    use_coefficient_cache_(false),
+    use_factorization_cache_(false),
+    version_(0),
+    num_threads_(1)
 {
     static_assert(std::is_floating_point<T>::value, "T must be a floating point type.");
     static_assert(NumPoints != 1, "NumPoints must be either 'Dynamic' or greater than 1.");
 }
 
-template<typename T, std::size_t NumPoints, std::size_t NumDims>
-void Spline<T, NumPoints, NumDims>::set(
+template<typename T, std::size_t NumPoints, std::size_t NumDims, typename Layout>
+void Spline<T, NumPoints, NumDims, Layout>::set(
     const T *points,
     const std::size_t num_points,
     const std::size_t num_dims,
@@ -82,24 +118,44 @@ void Spline<T, NumPoints, NumDims>::set(
     const T *left_tangent,
     const T *right_tangent
 ) {
-    // Assign pointer to pivot points
+    // Assign pointer to pivot points, invalidates cursors
+    version_++;
     num_points_ = num_points;
     num_dims_ = num_dims;
     points_ = points;
+    left_bc_ = left_bc;
+    right_bc_ = right_bc;
 
     // In case of dynamic size, resize moments
     if(NumPoints == Dynamic || NumDims == Dynamic)
     {
-        moments_.resize(num_points_*num_dims_);
+        moments_.resize(num_points_*internal::LayoutTraits<Layout>::padded_dims(num_dims_));
+    }
+
+    // Compute moments, unrolled at compile time for small fixed sizes that
+    // are used in full
+    typedef internal::FixedSolver<T, NumPoints,
+        std::is_same<Layout, layout::AoS>::value ? NumDims : Dynamic> FixedSolver;
+    if(FixedSolver::enabled && num_points_ == NumPoints && num_dims_ == NumDims)
+    {
+        FixedSolver::solve(points_, left_bc, right_bc, left_tangent, right_tangent, moments_.data());
+    }
+    else
+    {
+        compute_moments(points_, num_points_, num_dims_, left_bc, right_bc,
+            left_tangent, right_tangent, factorization(left_bc, right_bc), moments_,
+            num_threads_, partition_workspace_);
     }
 
-    // Compute moments
-    compute_moments(points_, num_points_, num_dims_, left_bc, right_bc,
-        left_tangent, right_tangent, moments_);
+    // Precompute polynomial coefficients
+    if(use_coefficient_cache_)
+    {
+        compute_coefficients();
+    }
 }
 
-template<typename T, std::size_t NumPoints, std::size_t NumDims>
-void Spline<T, NumPoints, NumDims>::set(
+template<typename T, std::size_t NumPoints, std::size_t NumDims, typename Layout>
+void Spline<T, NumPoints, NumDims, Layout>::set(
     const T *points,
     const std::size_t num_points,
     const BoundaryCondition left_bc,
@@ -112,8 +168,8 @@ void Spline<T, NumPoints, NumDims>::set(
     set(points, num_points, NumDims, left_bc, right_bc, left_tangent, right_tangent);
 }
 
-template<typename T, std::size_t NumPoints, std::size_t NumDims>
-void Spline<T, NumPoints, NumDims>::set(
+template<typename T, std::size_t NumPoints, std::size_t NumDims, typename Layout>
+void Spline<T, NumPoints, NumDims, Layout>::set(
     const T *points,
     const BoundaryCondition left_bc,
     const BoundaryCondition right_bc,
@@ -126,12 +182,18 @@ void Spline<T, NumPoints, NumDims>::set(
     set(points, NumPoints, NumDims, left_bc, right_bc, left_tangent, right_tangent);
 }
 
-template<typename T, std::size_t NumPoints, std::size_t NumDims>
-void Spline<T, NumPoints, NumDims>::eval(
+template<typename T, std::size_t NumPoints, std::size_t NumDims, typename Layout>
+void Spline<T, NumPoints, NumDims, Layout>::eval(
     const T pos,
     T *out_point
-)
+) const
 {
+    if(use_coefficient_cache_)
+    {
+        eval_cached(pos, out_point);
+        return;
+    }
+
     std::size_t i = floor(pos * (num_points_ - 1));
     T t = fmod(pos * (num_points_ - 1), 1.0);
     if(i == num_points_ - 1)
@@ -144,27 +206,712 @@ void Spline<T, NumPoints, NumDims>::eval(
     T t1 = pow(1-t, 3.0);
     for(std::size_t j = 0; j < num_dims_; j++)
     {
-        T c = (points_[(i+1)*num_dims_+j] - points_[i*num_dims_+j]) - 1.0/6.0*(moments_[(i+1)*num_dims_+j] - moments_[i*num_dims_+j]);
-        T d = points_[i*num_dims_+j] - 1.0/6.0*moments_[i*num_dims_+j];
-        *out_point++ = 1.0/6.0*(t1*moments_[i*num_dims_+j] + t0*moments_[(i+1)*num_dims_+j]) + c*t + d;
+        const T m0 = moments_[moment_index(i, j)];
+        const T m1 = moments_[moment_index(i+1, j)];
+        T c = (points_[(i+1)*num_dims_+j] - points_[i*num_dims_+j]) - 1.0/6.0*(m1 - m0);
+        T d = points_[i*num_dims_+j] - 1.0/6.0*m0;
+        *out_point++ = 1.0/6.0*(t1*m0 + t0*m1) + c*t + d;
+    }
+}
+
+template<typename T, std::size_t NumPoints, std::size_t NumDims, typename Layout>
+void Spline<T, NumPoints, NumDims, Layout>::set_batch(
+    Spline *splines,
+    const T *const *points,
+    const std::size_t num_splines,
+    const std::size_t num_points,
+    const std::size_t num_dims,
+    const BoundaryCondition left_bc,
+    const BoundaryCondition right_bc,
+    const T *const *left_tangents,
+    const T *const *right_tangents
+) {
+    if(num_splines == 0) return;
+
+    // Assign pointers to pivot points, invalidates cursors
+    for(std::size_t k = 0; k < num_splines; k++)
+    {
+        Spline &spline = splines[k];
+        spline.version_++;
+        spline.num_points_ = num_points;
+        spline.num_dims_ = num_dims;
+        spline.points_ = points[k];
+        spline.left_bc_ = left_bc;
+        spline.right_bc_ = right_bc;
+        if(NumPoints == Dynamic || NumDims == Dynamic)
+        {
+            spline.moments_.resize(num_points*internal::LayoutTraits<Layout>::padded_dims(num_dims));
+        }
+    }
+
+    // Equal size and boundary conditions, hence a single factorization
+    const internal::Factorization<T, NumPoints> &factorization =
+        splines[0].factorization(left_bc, right_bc);
+
+    // Interleave the right-hand sides of a group of splines row by row, the
+    // substitution sweeps then run over all columns of the group at once
+    internal::StorageType<T, Dynamic> &d = splines[0].partition_workspace_;
+    for(std::size_t s = 0; s < num_splines; s += internal::batch_size)
+    {
+        const std::size_t num_group = std::min(internal::batch_size, num_splines - s);
+        const std::size_t stride = num_group*num_dims;
+        d.resize(num_points*stride);
+
+        for(std::size_t k = 0; k < num_group; k++)
+        {
+            assemble_rhs(points[s+k], num_points, num_dims, left_bc, right_bc,
+                left_tangents ? left_tangents[s+k] : nullptr,
+                right_tangents ? right_tangents[s+k] : nullptr,
+                0, num_points, 0, num_dims, d.data() + k*num_dims, stride);
+        }
+
+        tdma(num_points, stride, stride, factorization, d.data());
+
+        for(std::size_t k = 0; k < num_group; k++)
+        {
+            Spline &spline = splines[s+k];
+            for(std::size_t i = 0; i < num_points; i++)
+            {
+                for(std::size_t j = 0; j < num_dims; j++)
+                {
+                    spline.moments_[spline.moment_index(i, j)] = d[i*stride+k*num_dims+j];
+                }
+            }
+            if(spline.use_coefficient_cache_)
+            {
+                spline.compute_coefficients();
+            }
+        }
     }
 }
 
-template<typename T, std::size_t NumPoints, std::size_t NumDims>
-void Spline<T, NumPoints, NumDims>::eval(
+template<typename T, std::size_t NumPoints, std::size_t NumDims, typename Layout>
+void Spline<T, NumPoints, NumDims, Layout>::update_point(
+    const std::size_t i,
+    const T *old_point
+)
+{
+    // The moments are linear in the points, moving point i changes at most
+    // three rows of d (five if periodic) and the moments by A^-1 times that
+    // change. Its columns decay away from the changed rows by about
+    // 2 - sqrt(3) per row, hence both sweeps only run until the change has
+    // dropped below machine precision relative to its largest entry.
+    version_++;
+    const std::size_t n = num_points_;
+    const std::size_t num_dims = num_dims_;
+    const internal::Factorization<T, NumPoints> &factorization = this->factorization(left_bc_, right_bc_);
+    const internal::StorageType<T, NumPoints> &f = factorization.f;
+    const internal::StorageType<T, NumPoints> &inv_b = factorization.inv_b;
+    const internal::StorageType<T, NumPoints> &c = factorization.c;
+    const T epsilon = std::numeric_limits<T>::epsilon();
+
+    std::size_t rows[5];
+    std::size_t num_rows = 0;
+    for(std::size_t r : {i + n - 1, i, i + 1, n, 2*n - 1})
+    {
+        r %= n;
+        if(rhs_weight(r, i) != 0 && std::find(rows, rows + num_rows, r) == rows + num_rows) rows[num_rows++] = r;
+    }
+    if(num_rows == 0) return;
+    const std::size_t row_begin = *std::min_element(rows, rows + num_rows);
+    const std::size_t row_end = *std::max_element(rows, rows + num_rows) + 1;
+
+    // Change of d, only the rows touched by the sweeps are initialized
+    internal::StorageType<T, Dynamic> &delta = partition_workspace_;
+    auto add_rhs = [&](T *d)
+    {
+        for(std::size_t k = 0; k < num_rows; k++)
+        {
+            const T weight = rhs_weight(rows[k], i);
+            for(std::size_t j = 0; j < num_dims; j++)
+            {
+                d[rows[k]*num_dims+j] += weight*(points_[i*num_dims+j] - old_point[j]);
+            }
+        }
+    };
+
+    std::size_t begin = 0, end = n;
+    bool is_local = n >= internal::min_local_update;
+    if(is_local)
+    {
+        // Forward elimination from the first changed row on, zero before
+        delta.resize(n*num_dims);
+        std::fill(delta.data() + row_begin*num_dims, delta.data() + row_end*num_dims, T(0.0));
+        add_rhs(delta.data());
+        T *d = delta.data();
+        T scale = 0.0;
+        end = row_begin + 1;
+        for(std::size_t k = row_begin; k < n; k++, end++)
+        {
+            T largest = 0.0;
+            for(std::size_t j = 0; j < num_dims; j++)
+            {
+                if(k >= row_end) d[k*num_dims+j] = 0.0;
+                if(k > row_begin) d[k*num_dims+j] -= f[k]*d[(k-1)*num_dims+j];
+                largest = std::max(largest, std::abs(d[k*num_dims+j]));
+            }
+            scale = std::max(scale, largest);
+            if(k >= row_end && largest <= epsilon*scale) break;
+        }
+        end = std::min(end, n);
+
+        // Backward substitution, the rows after end are negligible
+        scale = 0.0;
+        begin = end;
+        for(std::size_t k = end; k-- > 0; begin--)
+        {
+            T largest = 0.0;
+            for(std::size_t j = 0; j < num_dims; j++)
+            {
+                if(k < row_begin) d[k*num_dims+j] = 0.0;
+                const T next = k + 1 < end ? d[(k+1)*num_dims+j] : T(0.0);
+                d[k*num_dims+j] = (d[k*num_dims+j] - c[k]*next)*inv_b[k];
+                largest = std::max(largest, std::abs(d[k*num_dims+j]));
+            }
+            scale = std::max(scale, largest);
+            if(k < row_begin && largest <= epsilon*scale)
+            {
+                begin = k;
+                break;
+            }
+        }
+
+        // The Sherman-Morrison correction of periodic splines couples both
+        // ends, which is only negligible away from them
+        if(factorization.is_perturbed && (begin == 0 || end == n)) is_local = false;
+    }
+    if(!is_local)
+    {
+        begin = 0;
+        end = n;
+        delta.resize(n*num_dims);
+        std::fill(delta.data(), delta.data() + n*num_dims, T(0.0));
+        add_rhs(delta.data());
+        tdma(n, num_dims, num_dims, factorization, delta.data());
+    }
+
+    for(std::size_t k = begin; k < end; k++)
+    {
+        for(std::size_t j = 0; j < num_dims; j++)
+        {
+            moments_[moment_index(k, j)] += delta[k*num_dims+j];
+        }
+    }
+
+    // Not-a-knot end moments follow the inner ones
+    if(is_local && (factorization.left_not_a_knot || factorization.right_not_a_knot))
+    {
+        for(std::size_t j = 0; j < num_dims; j++)
+        {
+            if(factorization.left_not_a_knot && begin <= 2)
+            {
+                moments_[moment_index(0, j)] = 2.0*moments_[moment_index(1, j)] - moments_[moment_index(2, j)];
+            }
+            if(factorization.right_not_a_knot && end + 3 > n)
+            {
+                moments_[moment_index(n-1, j)] = 2.0*moments_[moment_index(n-2, j)] - moments_[moment_index(n-3, j)];
+            }
+        }
+        begin = factorization.left_not_a_knot && begin <= 2 ? 0 : begin;
+        end = factorization.right_not_a_knot && end + 3 > n ? n : end;
+    }
+
+    // Coefficients of the segments touching changed moments or point i
+    if(use_coefficient_cache_)
+    {
+        const std::size_t segment_begin = std::min(begin, i) > 0 ? std::min(begin, i) - 1 : 0;
+        const std::size_t segment_end = std::min(std::max(end, i + 1), n - 1);
+        for(std::size_t k = segment_begin; k < segment_end; k++)
+        {
+            for(std::size_t j = 0; j < num_dims; j++)
+            {
+                power_basis(points_[k*num_dims+j], points_[(k+1)*num_dims+j],
+                    moments_[moment_index(k, j)], moments_[moment_index(k+1, j)],
+                    &coefficients_[coefficient_index(k, j)]);
+            }
+        }
+    }
+}
+
+template<typename T, std::size_t NumPoints, std::size_t NumDims, typename Layout>
+T Spline<T, NumPoints, NumDims, Layout>::rhs_weight(
+    const std::size_t row,
+    const std::size_t i
+) const
+{
+    // Factor of point i in row of d, see assemble_rhs()
+    const std::size_t n = num_points_;
+    BoundaryCondition bc = BoundaryCondition::Periodic;
+    if(row == 0) bc = left_bc_;
+    else if(row == n - 1) bc = right_bc_;
+    const std::size_t prev = row > 0 ? row - 1 : n - 1;
+    const std::size_t next = row + 1 < n ? row + 1 : 0;
+
+    switch(bc)
+    {
+    case BoundaryCondition::Hermite:
+        if(row == 0) return T(6.0)*((i == 1) - (i == 0));
+        return T(6.0)*((i == n - 2) - (i == n - 1));
+    case BoundaryCondition::Periodic:
+        // inner rows and periodic ends
+        return T(6.0)*((i == next) + (i == prev)) - T(12.0)*(i == row);
+    default: // BoundaryCondition::Natural, BoundaryCondition::NotAKnot
+        return 0.0;
+    }
+}
+
+template<typename T, std::size_t NumPoints, std::size_t NumDims, typename Layout>
+void Spline<T, NumPoints, NumDims, Layout>::eval(
     const T *pos,
     const std::size_t num_pos,
     T *out_points
-)
+) const
+{
+    eval_batch(pos, num_pos, out_points, num_threads_);
+}
+
+template<typename T, std::size_t NumPoints, std::size_t NumDims, typename Layout>
+void Spline<T, NumPoints, NumDims, Layout>::eval_parallel(
+    const T *pos,
+    const std::size_t num_pos,
+    T *out_points,
+    const std::size_t num_threads
+) const
+{
+    eval_batch(pos, num_pos, out_points, num_threads);
+}
+
+template<typename T, std::size_t NumPoints, std::size_t NumDims, typename Layout>
+void Spline<T, NumPoints, NumDims, Layout>::eval_batch(
+    const T *pos,
+    const std::size_t num_pos,
+    T *out_points,
+    const std::size_t num_threads
+) const
+{
+    // Tasks cover a chunk of positions and, with many dimensions stored
+    // contiguously, a chunk of dimensions. Position chunks span whole cache
+    // lines of the output, hence threads do not share lines except at
+    // unaligned ends.
+    const bool use_channels = internal::LayoutTraits<Layout>::block_width(num_dims_) >= internal::channel_min_dims;
+    const std::size_t num_dim_chunks = use_channels
+        ? (num_dims_ + internal::channel_chunk - 1)/internal::channel_chunk : 1;
+    const std::size_t num_pos_chunks = (num_pos + internal::position_chunk - 1)/internal::position_chunk;
+    const bool is_parallel = num_pos*num_dims_ >= internal::min_parallel_work;
+    internal::ThreadPool::instance().parallel_for(num_pos_chunks*num_dim_chunks, is_parallel ? num_threads : 1,
+        [&](const std::size_t task)
+        {
+            const std::size_t begin = (task/num_dim_chunks)*internal::position_chunk;
+            const std::size_t count = std::min(num_pos - begin, internal::position_chunk);
+            if(use_channels)
+            {
+                // Vectorized across dimensions instead of positions
+                const std::size_t dim_begin = (task%num_dim_chunks)*internal::channel_chunk;
+                const std::size_t dim_end = std::min(num_dims_, dim_begin + internal::channel_chunk);
+                eval_channels(pos + begin, count, dim_begin, dim_end, out_points + begin*num_dims_);
+                return;
+            }
+
+            std::size_t i = 0;
+            if(use_coefficient_cache_)
+            {
+                // Vectorized across positions, remainder handled by the scalar path
+                i = internal::CoefficientKernel<T>::eval(coefficients_.data(), num_points_, num_dims_,
+                    internal::LayoutTraits<Layout>::block_width(num_dims_), pos + begin, count,
+                    out_points + begin*num_dims_);
+            }
+            for(; i < count; i++)
+            {
+                eval(pos[begin+i], &(out_points[(begin+i)*num_dims_]));
+            }
+        });
+}
+
+template<typename T, std::size_t NumPoints, std::size_t NumDims, typename Layout>
+void Spline<T, NumPoints, NumDims, Layout>::eval_channels(
+    const T *pos,
+    const std::size_t num_pos,
+    const std::size_t dim_begin,
+    const std::size_t dim_end,
+    T *out_points
+) const
+{
+    // Each position evaluates contiguous runs of dimensions
+    const std::size_t width = internal::LayoutTraits<Layout>::block_width(num_dims_);
+    for(std::size_t p = 0; p < num_pos; p++)
+    {
+        std::size_t i;
+        T t;
+        locate(pos[p], i, t);
+        for(std::size_t j = dim_begin; j < dim_end;)
+        {
+            const std::size_t run_end = std::min(dim_end, (j/width + 1)*width);
+            internal::SegmentKernel<T>::eval(
+                points_ + i*num_dims_ + j, points_ + (i+1)*num_dims_ + j,
+                &moments_[moment_index(i, j)], &moments_[moment_index(i+1, j)],
+                t, run_end - j, out_points + p*num_dims_ + j);
+            j = run_end;
+        }
+    }
+}
+
+template<typename T, std::size_t NumPoints, std::size_t NumDims, typename Layout>
+void Spline<T, NumPoints, NumDims, Layout>::eval(
+    const T *pos,
+    const std::size_t num_pos,
+    T *out_points,
+    T *out_first,
+    T *out_second,
+    T *out_third
+) const
+{
+    // Chain rule factors of the local parameter t = pos*(n-1) - i
+    const T scale1 = num_points_ - 1;
+    const T scale2 = scale1*scale1;
+    const T scale3 = scale2*scale1;
+
+    for(std::size_t p = 0; p < num_pos; p++)
+    {
+        std::size_t i;
+        T t;
+        locate(pos[p], i, t);
+
+        for(std::size_t j = 0; j < num_dims_; j++)
+        {
+            T buffer[4];
+            const T *coeffs = segment_coefficients(i, j, buffer);
+            const std::size_t k = p*num_dims_ + j;
+            if(out_points) out_points[k] = ((coeffs[3]*t + coeffs[2])*t + coeffs[1])*t + coeffs[0];
+            if(out_first) out_first[k] = scale1*((3.0*coeffs[3]*t + 2.0*coeffs[2])*t + coeffs[1]);
+            if(out_second) out_second[k] = scale2*(6.0*coeffs[3]*t + 2.0*coeffs[2]);
+            if(out_third) out_third[k] = scale3*6.0*coeffs[3];
+        }
+    }
+}
+
+template<typename T, std::size_t NumPoints, std::size_t NumDims, typename Layout>
+void Spline<T, NumPoints, NumDims, Layout>::eval_uniform(
+    const std::size_t num_samples,
+    T *out_points
+) const
+{
+    if(num_samples < 2)
+    {
+        const T pos = 0.0;
+        if(num_samples == 1) eval(&pos, 1, out_points, nullptr, nullptr);
+        return;
+    }
+
+    // Sample k lies at t = (k*(n-1) - i*(K-1))/(K-1) on segment i, integer
+    // numerators keep segment boundaries exact. Forward differences are
+    // re-anchored periodically to bound the error growth.
+    const std::size_t num_segments = num_points_ - 1;
+    const std::size_t num_steps = num_samples - 1;
+    const std::size_t anchor_interval = sizeof(T) < sizeof(double) ? 32 : 1024;
+    const T step = T(num_segments)/num_steps;
+    const T step2 = step*step;
+    const T step3 = step2*step;
+
+    std::size_t k_begin = 0;
+    for(std::size_t i = 0; i < num_segments; i++)
+    {
+        // Samples with i <= pos*(n-1) < i+1, the last segment includes pos = 1
+        std::size_t k_end = (i == num_segments - 1) ? num_samples
+            : ((i+1)*num_steps + num_segments - 1)/num_segments;
+
+        for(std::size_t j = 0; j < num_dims_; j++)
+        {
+            T buffer[4];
+            const T *coeffs = segment_coefficients(i, j, buffer);
+            T p = 0.0, d1 = 0.0, d2 = 0.0;
+            const T d3 = 6.0*coeffs[3]*step3;
+            for(std::size_t k = k_begin; k < k_end; k++)
+            {
+                if((k - k_begin) % anchor_interval == 0)
+                {
+                    T t = T(k*num_segments - i*num_steps)/num_steps;
+                    p = ((coeffs[3]*t + coeffs[2])*t + coeffs[1])*t + coeffs[0];
+                    d1 = coeffs[1]*step + coeffs[2]*(2.0*t*step + step2)
+                        + coeffs[3]*(3.0*t*t*step + 3.0*t*step2 + step3);
+                    d2 = 2.0*coeffs[2]*step2 + coeffs[3]*(6.0*t*step2 + 6.0*step3);
+                }
+                out_points[k*num_dims_+j] = p;
+                p += d1;
+                d1 += d2;
+                d2 += d3;
+            }
+        }
+        k_begin = k_end;
+    }
+}
+
+template<typename T, std::size_t NumPoints, std::size_t NumDims, typename Layout>
+void Spline<T, NumPoints, NumDims, Layout>::eval(
+    Cursor &cursor,
+    const T pos,
+    T *out_point
+) const
+{
+    // Stay on the current segment as long as the position is covered by it,
+    // the first and last segment extend to the respective side
+    T t = pos * (num_points_ - 1) - cursor.segment_;
+    if(cursor.spline_ != this || cursor.version_ != version_
+        || (t < 0 && cursor.segment_ > 0)
+        || (t > 1 && cursor.segment_ < num_points_ - 2))
+    {
+        std::size_t i;
+        locate(pos, i, t);
+        load_segment(cursor, i);
+    }
+
+    const T *coeffs = cursor.coefficients_ ? cursor.coefficients_ : cursor.buffer_.data();
+    for(std::size_t j = 0; j < num_dims_; j++, coeffs += 4)
+    {
+        *out_point++ = ((coeffs[3]*t + coeffs[2])*t + coeffs[1])*t + coeffs[0];
+    }
+}
+
+template<typename T, std::size_t NumPoints, std::size_t NumDims, typename Layout>
+void Spline<T, NumPoints, NumDims, Layout>::eval(
+    Cursor &cursor,
+    const T *pos,
+    const std::size_t num_pos,
+    T *out_points
+) const
 {
     for(std::size_t i = 0; i < num_pos; i++)
     {
-        eval(pos[i], &(out_points[i*num_dims_]));
+        eval(cursor, pos[i], &(out_points[i*num_dims_]));
     }
 }
 
-template<typename T, std::size_t NumPoints, std::size_t NumDims>
-void Spline<T, NumPoints, NumDims>::compute_moments(
+template<typename T, std::size_t NumPoints, std::size_t NumDims, typename Layout>
+void Spline<T, NumPoints, NumDims, Layout>::load_segment(
+    Cursor &cursor,
+    const std::size_t i
+) const
+{
+    cursor.spline_ = this;
+    cursor.version_ = version_;
+    cursor.segment_ = i;
+    if(use_coefficient_cache_ && std::is_same<Layout, layout::AoS>::value)
+    {
+        cursor.coefficients_ = &coefficients_[coefficient_index(i, 0)];
+        return;
+    }
+
+    // Expand or gather the segment once, reused until the cursor leaves it
+    cursor.coefficients_ = nullptr;
+    if(NumDims == Dynamic)
+    {
+        cursor.buffer_.resize(4*num_dims_);
+    }
+    for(std::size_t j = 0; j < num_dims_; j++)
+    {
+        const T *coeffs = segment_coefficients(i, j, &cursor.buffer_[4*j]);
+        if(coeffs != &cursor.buffer_[4*j])
+        {
+            std::copy(coeffs, coeffs + 4, &cursor.buffer_[4*j]);
+        }
+    }
+}
+
+template<typename T, std::size_t NumPoints, std::size_t NumDims, typename Layout>
+std::size_t Spline<T, NumPoints, NumDims, Layout>::num_points() const
+{
+    return num_points_;
+}
+
+template<typename T, std::size_t NumPoints, std::size_t NumDims, typename Layout>
+std::size_t Spline<T, NumPoints, NumDims, Layout>::num_dims() const
+{
+    return num_dims_;
+}
+
+template<typename T, std::size_t NumPoints, std::size_t NumDims, typename Layout>
+void Spline<T, NumPoints, NumDims, Layout>::reserve(
+    const std::size_t num_points,
+    const std::size_t num_dims
+)
+{
+    // Resizing within the reserved capacity keeps the allocation
+    const std::size_t num_padded_dims = internal::LayoutTraits<Layout>::padded_dims(num_dims);
+    moments_.reserve(num_points*num_padded_dims);
+    factorization_.reserve(num_points);
+    if(use_coefficient_cache_)
+    {
+        coefficients_.reserve(4*num_points*num_padded_dims);
+    }
+}
+
+template<typename T, std::size_t NumPoints, std::size_t NumDims, typename Layout>
+void Spline<T, NumPoints, NumDims, Layout>::enable_coefficient_cache(
+    const bool enable
+)
+{
+    version_++;
+    use_coefficient_cache_ = enable;
+    if(use_coefficient_cache_ && points_)
+    {
+        compute_coefficients();
+    }
+}
+
+template<typename T, std::size_t NumPoints, std::size_t NumDims, typename Layout>
+void Spline<T, NumPoints, NumDims, Layout>::enable_factorization_cache(
+    const bool enable
+)
+{
+    use_factorization_cache_ = enable;
+    if(!use_factorization_cache_)
+    {
+        shared_factorization_.reset();
+    }
+}
+
+template<typename T, std::size_t NumPoints, std::size_t NumDims, typename Layout>
+void Spline<T, NumPoints, NumDims, Layout>::set_num_threads(
+    const std::size_t num_threads
+)
+{
+    num_threads_ = num_threads;
+}
+
+template<typename T, std::size_t NumPoints, std::size_t NumDims, typename Layout>
+void Spline<T, NumPoints, NumDims, Layout>::clear_factorization_cache()
+{
+    internal::FactorizationCache<T, NumPoints>::clear();
+}
+
+template<typename T, std::size_t NumPoints, std::size_t NumDims, typename Layout>
+std::size_t Spline<T, NumPoints, NumDims, Layout>::moment_index(
+    const std::size_t i,
+    const std::size_t j
+) const
+{
+    return internal::LayoutTraits<Layout>::index(i, j, num_points_, num_dims_);
+}
+
+template<typename T, std::size_t NumPoints, std::size_t NumDims, typename Layout>
+std::size_t Spline<T, NumPoints, NumDims, Layout>::coefficient_index(
+    const std::size_t i,
+    const std::size_t j
+) const
+{
+    // Coefficients (a, b, c, d) of a segment and dimension are contiguous,
+    // segments and dimensions follow the layout of the moments
+    return 4*internal::LayoutTraits<Layout>::index(i, j, num_points_ - 1, num_dims_);
+}
+
+template<typename T, std::size_t NumPoints, std::size_t NumDims, typename Layout>
+void Spline<T, NumPoints, NumDims, Layout>::locate(
+    const T pos,
+    std::size_t &i,
+    T &t
+) const
+{
+    // Truncation equals floor for non-negative values, positions outside of
+    // [0, 1] are extrapolated from the first or last segment
+    T s = pos * (num_points_ - 1);
+    i = s > 0 ? static_cast<std::size_t>(s) : 0;
+    if(i > num_points_ - 2) i = num_points_ - 2;
+    t = s - i;
+}
+
+template<typename T, std::size_t NumPoints, std::size_t NumDims, typename Layout>
+void Spline<T, NumPoints, NumDims, Layout>::eval_cached(
+    const T pos,
+    T *out_point
+) const
+{
+    std::size_t i;
+    T t;
+    locate(pos, i, t);
+
+    // Horner scheme on coefficients (a, b, c, d) of segment i
+    for(std::size_t j = 0; j < num_dims_; j++)
+    {
+        const T *coeffs = &coefficients_[coefficient_index(i, j)];
+        *out_point++ = ((coeffs[3]*t + coeffs[2])*t + coeffs[1])*t + coeffs[0];
+    }
+}
+
+template<typename T, std::size_t NumPoints, std::size_t NumDims, typename Layout>
+void Spline<T, NumPoints, NumDims, Layout>::compute_coefficients()
+{
+    // Allocated on first use so fixed-size splines without the cache stay small
+    coefficients_.resize(4*(num_points_-1)*internal::LayoutTraits<Layout>::padded_dims(num_dims_));
+
+    for(std::size_t i = 0; i < num_points_ - 1; i++)
+    {
+        for(std::size_t j = 0; j < num_dims_; j++)
+        {
+            power_basis(points_[i*num_dims_+j], points_[(i+1)*num_dims_+j],
+                moments_[moment_index(i, j)], moments_[moment_index(i+1, j)],
+                &coefficients_[coefficient_index(i, j)]);
+        }
+    }
+}
+
+template<typename T, std::size_t NumPoints, std::size_t NumDims, typename Layout>
+void Spline<T, NumPoints, NumDims, Layout>::power_basis(
+    const T p0,
+    const T p1,
+    const T m0,
+    const T m1,
+    T *coeffs
+)
+{
+    // Expand the moment representation of a segment in the local parameter t
+    // into the power basis a + b*t + c*t^2 + d*t^3
+    coeffs[0] = p0;
+    coeffs[1] = (p1 - p0) - 1.0/6.0*(2.0*m0 + m1);
+    coeffs[2] = 0.5*m0;
+    coeffs[3] = 1.0/6.0*(m1 - m0);
+}
+
+template<typename T, std::size_t NumPoints, std::size_t NumDims, typename Layout>
+const T* Spline<T, NumPoints, NumDims, Layout>::segment_coefficients(
+    const std::size_t i,
+    const std::size_t j,
+    T *buffer
+) const
+{
+    if(use_coefficient_cache_)
+    {
+        return &coefficients_[coefficient_index(i, j)];
+    }
+    power_basis(points_[i*num_dims_+j], points_[(i+1)*num_dims_+j],
+        moments_[moment_index(i, j)], moments_[moment_index(i+1, j)], buffer);
+    return buffer;
+}
+
+template<typename T, std::size_t NumPoints, std::size_t NumDims, typename Layout>
+const internal::Factorization<T, NumPoints>& Spline<T, NumPoints, NumDims, Layout>::factorization(
+    const BoundaryCondition left_bc,
+    const BoundaryCondition right_bc
+)
+{
+    // The system matrix only changes with size and boundary conditions
+    if(use_factorization_cache_)
+    {
+        if(!shared_factorization_ || !shared_factorization_->matches(num_points_, left_bc, right_bc))
+        {
+            shared_factorization_ = internal::FactorizationCache<T, NumPoints>::get(
+                num_points_, left_bc, right_bc);
+        }
+        return *shared_factorization_;
+    }
+
+    if(!factorization_.matches(num_points_, left_bc, right_bc))
+    {
+        factorization_.compute(num_points_, left_bc, right_bc);
+    }
+    return factorization_;
+}
+
+template<typename T, std::size_t NumPoints, std::size_t NumDims, typename Layout>
+void Spline<T, NumPoints, NumDims, Layout>::assemble_rhs(
     const T* points,
     const std::size_t num_points,
     const std::size_t num_dims,
@@ -172,13 +919,18 @@ void Spline<T, NumPoints, NumDims>::compute_moments(
     const BoundaryCondition right_bc,
     const T* left_tangent,
     const T* right_tangent,
-    internal::StorageType<T, NumPoints*NumDims> &m
+    const std::size_t begin,
+    const std::size_t end,
+    const std::size_t dim_begin,
+    const std::size_t dim_end,
+    T *d,
+    const std::size_t stride
 )
 {
-    // Initialize auxilliary storage
-    internal::StorageType<T, NumPoints> a(num_points), b(num_points), c(num_points);
-
-    for(std::size_t i = 0; i < num_points; i++)
+    // Rows [begin, end) and dimensions [dim_begin, dim_end) of the right-hand
+    // side, row i starts at d + i*stride with dimension dim_begin
+    d -= dim_begin;
+    for(std::size_t i = begin; i < end; i++)
     {
         if(i == 0)
         {
@@ -186,40 +938,26 @@ void Spline<T, NumPoints, NumDims>::compute_moments(
             switch(left_bc)
             {
             case BoundaryCondition::Hermite:
-                a[i] = 0.0;
-                b[i] = 2.0;
-                c[i] = 1.0;
-                for(std::size_t j = 0; j < num_dims; j++)
+                for(std::size_t j = dim_begin; j < dim_end; j++)
                 {
-                    // store d in moments_
                     T tangent_component = 0.0;
                     if(left_tangent) tangent_component = left_tangent[j];
-                    m[i*num_dims+j] = 6.0 * ((points[(i+1)*num_dims+j] - points[i*num_dims+j]) - tangent_component);
+                    d[i*stride+j] = 6.0 * ((points[(i+1)*num_dims+j] - points[i*num_dims+j]) - tangent_component);
                 }
                 break;
             case BoundaryCondition::Periodic:
-                a[i] = 1.0;
-                b[i] = 4.0;
-                c[i] = 1.0;
-                for(std::size_t j = 0; j < num_dims; j++)
+                for(std::size_t j = dim_begin; j < dim_end; j++)
                 {
-                    // store d in moments_
-                    m[i*num_dims+j] = 6.0 * ((points[(i+1)*num_dims+j] - points[i*num_dims+j])
+                    d[i*stride+j] = 6.0 * ((points[(i+1)*num_dims+j] - points[i*num_dims+j])
                             - (points[i*num_dims+j] - points[(num_points-1)*num_dims+j]));
                 }
                 break;
-            // TODO
-            //case BoundaryCondition::NotAKnot:
-            //    break;
-            //
+            case BoundaryCondition::NotAKnot:
+                // zero, the end moment is extrapolated after the solve
             default: // BoundaryCondition::Natural
-                a[i] = 0.0;
-                b[i] = 1.0;
-                c[i] = 0.0;
-                for(std::size_t j = 0; j < num_dims; j++)
+                for(std::size_t j = dim_begin; j < dim_end; j++)
                 {
-                    // store d in moments_
-                    m[i*num_dims+j] = 0.0;
+                    d[i*stride+j] = 0.0;
                 }
             }
         }
@@ -229,147 +967,330 @@ void Spline<T, NumPoints, NumDims>::compute_moments(
             switch(right_bc)
             {
             case BoundaryCondition::Hermite:
-                a[i] = 1.0;
-                b[i] = 2.0;
-                c[i] = 0.0;
-                for(std::size_t j = 0; j < num_dims; j++)
+                for(std::size_t j = dim_begin; j < dim_end; j++)
                 {
-                    // store d in moments_
                     T tangent_component = 0.0;
                     if(right_tangent) tangent_component = right_tangent[j];
-                    m[i*num_dims+j] = 6.0 * (tangent_component - (points[i*num_dims+j] - points[(i-1)*num_dims+j]));
+                    d[i*stride+j] = 6.0 * (tangent_component - (points[i*num_dims+j] - points[(i-1)*num_dims+j]));
                 }
                 break;
             case BoundaryCondition::Periodic:
-                a[i] = 1.0;
-                b[i] = 4.0;
-                c[i] = 1.0;
-                for(std::size_t j = 0; j < num_dims; j++)
+                for(std::size_t j = dim_begin; j < dim_end; j++)
                 {
-                    // store d in moments_
-                    m[i*num_dims+j] = 6.0 * ((points[0+j] - points[(num_points-1)*num_dims+j])
+                    d[i*stride+j] = 6.0 * ((points[0+j] - points[(num_points-1)*num_dims+j])
                         - (points[(num_points-1)*num_dims+j] - points[(num_points-2)*num_dims+j]));
                 }
                 break;
-            // TODO
-            //case BoundaryCondition::NotAKnot:
-            //    break;
-            ///
+            case BoundaryCondition::NotAKnot:
+                // zero, the end moment is extrapolated after the solve
             default: // BoundaryCondition::Natural
-                a[i] = 0.0;
-                b[i] = 1.0;
-                c[i] = 0.0;
-                for(std::size_t j = 0; j < num_dims; j++)
+                for(std::size_t j = dim_begin; j < dim_end; j++)
                 {
-                    // store d in moments_
-                    m[i*num_dims+j] = 0.0;
+                    d[i*stride+j] = 0.0;
                 }
             }
         }
         else
         {
             // inner node
-            a[i] = 1.0;
-            b[i] = 4.0;
-            c[i] = 1.0;
-            for(std::size_t j = 0; j < num_dims; j++)
+            for(std::size_t j = dim_begin; j < dim_end; j++)
             {
-                // store d in moments_
-                m[i*num_dims+j] = 6.0 * ((points[(i+1)*num_dims+j] - points[i*num_dims+j])
+                d[i*stride+j] = 6.0 * ((points[(i+1)*num_dims+j] - points[i*num_dims+j])
                     - (points[i*num_dims+j] - points[(i-1)*num_dims+j]));
             }
         }
     }
+}
 
-    // Solve spline problem
-    if(a[0] != 0 || c[num_points-1] != 0)
-    {
-        // perturbed problem
-        internal::StorageType<T, NumPoints> q(num_points);
-        tdma(num_points, num_dims, a, b, c, m, q.data());
-    }
-    else
+template<typename T, std::size_t NumPoints, std::size_t NumDims, typename Layout>
+void Spline<T, NumPoints, NumDims, Layout>::compute_moments(
+    const T* points,
+    const std::size_t num_points,
+    const std::size_t num_dims,
+    const BoundaryCondition left_bc,
+    const BoundaryCondition right_bc,
+    const T* left_tangent,
+    const T* right_tangent,
+    const internal::Factorization<T, NumPoints> &factorization,
+    internal::StorageType<T, NumPoints*NumPaddedDims> &m,
+    const std::size_t num_threads,
+    internal::StorageType<T, Dynamic> &workspace
+)
+{
+    // Each block of the layout is an independent system of width columns,
+    // padding columns are solved along with zero right-hand side
+    const std::size_t width = internal::LayoutTraits<Layout>::block_width(num_dims);
+    const std::size_t num_blocks = internal::LayoutTraits<Layout>::padded_dims(num_dims)/width;
+
+    // Very long systems, split along the rows
+    if(num_threads != 1 && num_points >= 2*internal::partition_size)
     {
-        // strictly tridiagonal problem
-        tdma(num_points, num_dims, a, b, c, m);
+        const std::size_t size = internal::partition_size;
+        const std::size_t num_partitions = (num_points + size - 1)/size;
+        internal::ThreadPool::instance().parallel_for(num_partitions, num_threads,
+            [&](const std::size_t k)
+            {
+                for(std::size_t b = 0; b < num_blocks; b++)
+                {
+                    assemble_block(m.data(), num_points, num_dims, width, b, 0, width,
+                        k*size, std::min(num_points, (k+1)*size),
+                        points, left_bc, right_bc, left_tangent, right_tangent);
+                }
+            });
+        for(std::size_t b = 0; b < num_blocks; b++)
+        {
+            tdma_partitioned(num_points, width, factorization, m.data() + b*num_points*width,
+                num_threads, workspace);
+        }
+        return;
     }
+
+    // Otherwise columns are independent, wide blocks are split into chunks
+    const std::size_t num_chunks = width >= 2*internal::channel_chunk
+        ? (width + internal::channel_chunk - 1)/internal::channel_chunk : 1;
+    const std::size_t chunk_width = num_chunks > 1 ? internal::channel_chunk : width;
+    const bool is_parallel = num_points*num_dims >= internal::min_parallel_work;
+    internal::ThreadPool::instance().parallel_for(num_blocks*num_chunks, is_parallel ? num_threads : 1,
+        [&](const std::size_t task)
+        {
+            const std::size_t b = task/num_chunks;
+            const std::size_t col_begin = (task%num_chunks)*chunk_width;
+            const std::size_t col_end = std::min(width, col_begin + chunk_width);
+            assemble_block(m.data(), num_points, num_dims, width, b, col_begin, col_end,
+                0, num_points, points, left_bc, right_bc, left_tangent, right_tangent);
+            tdma(num_points, col_end - col_begin, width, factorization,
+                m.data() + b*num_points*width + col_begin);
+        });
 }
 
-template<typename T, std::size_t NumPoints, std::size_t NumDims>
-void Spline<T, NumPoints, NumDims>::tdma(
+template<typename T, std::size_t NumPoints, std::size_t NumDims, typename Layout>
+void Spline<T, NumPoints, NumDims, Layout>::assemble_block(
+    T *m,
     const std::size_t num_points,
     const std::size_t num_dims,
-    internal::StorageType<T, NumPoints> &a,
-    internal::StorageType<T, NumPoints> &b,
-    internal::StorageType<T, NumPoints> &c,
-    internal::StorageType<T, NumPoints*NumDims> &d,
-    T *u
+    const std::size_t width,
+    const std::size_t b,
+    const std::size_t col_begin,
+    const std::size_t col_end,
+    const std::size_t begin,
+    const std::size_t end,
+    const T* points,
+    const BoundaryCondition left_bc,
+    const BoundaryCondition right_bc,
+    const T* left_tangent,
+    const T* right_tangent
 )
 {
-    // Perturbed problem?
-    bool is_perturbed = a[0] != 0 || c[num_points-1] != 0;
-    T vn = 0.0;
-    if(is_perturbed)
+    // Columns [col_begin, col_end) of block b, padding columns are zero
+    T *block = m + b*num_points*width;
+    const std::size_t dim_begin = std::min(num_dims, b*width + col_begin);
+    const std::size_t dim_end = std::min(num_dims, b*width + col_end);
+    assemble_rhs(points, num_points, num_dims, left_bc, right_bc, left_tangent, right_tangent,
+        begin, end, dim_begin, dim_end, block + (dim_begin - b*width), width);
+    for(std::size_t i = begin; i < end; i++)
     {
-        assert(u && "u must not be a null pointer.");
-
-        // Initialize q and u with zero
-        for(std::size_t i = 1; i <num_points; i++) u[i] = 0.0;
-
-        // Modify problem
-        vn = a[0]/b[0];
-        u[0] = -b[0];
-        u[num_points-1] = c[num_points-1];
-        a[0] = 0;
-        b[0] = 2*b[0];
-        b[num_points-1] = b[num_points-1] + c[num_points-1]*vn;
-        c[num_points-1] = 0;
+        std::fill(block + i*width + std::max(col_begin, dim_end - b*width), block + i*width + col_end, T(0.0));
     }
+}
+
+template<typename T, std::size_t NumPoints, std::size_t NumDims, typename Layout>
+void Spline<T, NumPoints, NumDims, Layout>::tdma(
+    const std::size_t num_points,
+    const std::size_t num_dims,
+    const std::size_t stride,
+    const internal::Factorization<T, NumPoints> &factorization,
+    T *d
+)
+{
+    const internal::StorageType<T, NumPoints> &f = factorization.f;
+    const internal::StorageType<T, NumPoints> &inv_b = factorization.inv_b;
+    const internal::StorageType<T, NumPoints> &c = factorization.c;
 
     // Forward elimination
     // i = 1 ... n:
     for(std::size_t i = 1; i < num_points; i++)
     {
-        T f = a[i]/b[i-1];
-        b[i] = b[i] - f*c[i-1];
-        if(is_perturbed) u[i] = u[i] - f*u[i-1];
-        for(std::size_t j = 0; j < num_dims; j++)
-        {
-            d[i*num_dims+j] = d[i*num_dims+j] - f*d[(i-1)*num_dims+j];
-        }
+        internal::SweepKernel<T>::eliminate(d + i*stride, d + (i-1)*stride, f[i], num_dims);
     }
 
     // Backward substitution
     // i = n:
-    if(is_perturbed) u[num_points-1] = u[num_points-1]/b[num_points-1];
     for(std::size_t j = 0; j < num_dims; j++)
     {
-        d[(num_points-1)*num_dims+j] = d[(num_points-1)*num_dims+j]/b[num_points-1];
+        d[(num_points-1)*stride+j] = d[(num_points-1)*stride+j]*inv_b[num_points-1];
     }
     // i = n-1 ... 0:
     for(int i = num_points-2; i >= 0; i--)
     {
-        if(is_perturbed) u[i] = (u[i] - c[i]*u[i+1])/b[i];
+        internal::SweepKernel<T>::substitute(d + i*stride, d + (i+1)*stride, c[i], inv_b[i], num_dims);
+    }
+
+    if(factorization.is_perturbed)
+    {
+        // Reconstruct solution row by row, the weight of a column depends on
+        // its first and last row, which are corrected last
+        const internal::StorageType<T, NumPoints> &q = factorization.q;
+        const T *first = d;
+        const T *last = d + (num_points-1)*stride;
+        for(std::size_t i = 1; i + 1 < num_points; i++)
+        {
+            for(std::size_t j = 0; j < num_dims; j++)
+            {
+                T k = (first[j] - last[j]*factorization.vn)*factorization.inv_vq;
+                d[i*stride+j] = d[i*stride+j] - k*q[i];
+            }
+        }
         for(std::size_t j = 0; j < num_dims; j++)
         {
-            d[i*num_dims+j] = (d[i*num_dims+j] - c[i]*d[(i+1)*num_dims+j])/b[i];
+            T k = (first[j] - last[j]*factorization.vn)*factorization.inv_vq;
+            d[j] = d[j] - k*q[0];
+            d[(num_points-1)*stride+j] = d[(num_points-1)*stride+j] - k*q[num_points-1];
         }
     }
+    internal::extrapolate_not_a_knot(factorization.left_not_a_knot, factorization.right_not_a_knot,
+        num_points, num_dims, stride, d);
+}
 
-    if(is_perturbed)
+template<typename T, std::size_t NumPoints, std::size_t NumDims, typename Layout>
+void Spline<T, NumPoints, NumDims, Layout>::tdma_partitioned(
+    const std::size_t num_points,
+    const std::size_t num_dims,
+    const internal::Factorization<T, NumPoints> &factorization,
+    T *d,
+    const std::size_t num_threads,
+    internal::StorageType<T, Dynamic> &workspace
+)
+{
+    // Each chunk [s, e) is solved independently assuming zero coupling to its
+    // neighbours. As both sweeps are linear recurrences, the true solution
+    // differs from the local one by the influence of a single coupling value
+    // per dimension, scaled by the products of the recurrence factors. These
+    // couplings follow from a small sequential sweep over the chunk ends.
+    const internal::StorageType<T, NumPoints> &f = factorization.f;
+    const internal::StorageType<T, NumPoints> &inv_b = factorization.inv_b;
+    const internal::StorageType<T, NumPoints> &c = factorization.c;
+    const std::size_t size = internal::partition_size;
+    const std::size_t num_partitions = (num_points + size - 1)/size;
+    internal::ThreadPool &pool = internal::ThreadPool::instance();
+
+    // Workspace: per chunk forward and backward influence factors, the
+    // coupling values per chunk and dimension of both sweeps and the
+    // Sherman-Morrison weights per dimension
+    workspace.resize(2*num_partitions + 2*num_partitions*num_dims + num_dims);
+    T *g = workspace.data();
+    T *h = g + num_partitions;
+    T *carry_forward = h + num_partitions;
+    T *carry_backward = carry_forward + num_partitions*num_dims;
+    T *weights = carry_backward + num_partitions*num_dims;
+
+    // Forward elimination, local to each chunk
+    pool.parallel_for(num_partitions, num_threads, [&](const std::size_t k)
     {
-        // Reconstruct solution
-        T vq = u[0] - u[num_points-1]*vn;
+        std::size_t s = k*size, e = std::min(num_points, s + size);
+        T factor = 1.0;
+        for(std::size_t i = s; i < e; i++)
+        {
+            factor *= -f[i];
+            if(i == s) continue;
+            for(std::size_t j = 0; j < num_dims; j++)
+            {
+                d[i*num_dims+j] = d[i*num_dims+j] - f[i]*d[(i-1)*num_dims+j];
+            }
+        }
+        g[k] = factor;
+    });
+
+    // Reduced system, last eliminated row of the preceding chunk
+    for(std::size_t j = 0; j < num_dims; j++) carry_forward[j] = 0.0;
+    for(std::size_t k = 1; k < num_partitions; k++)
+    {
+        std::size_t last = k*size - 1;
         for(std::size_t j = 0; j < num_dims; j++)
         {
-            T vy = d[j] - d[(num_points-1)*num_dims+j]*vn;
-            T k = vy/(1 + vq);
-            for(std::size_t i = 0; i < num_points; i++)
+            carry_forward[k*num_dims+j] = d[last*num_dims+j] + g[k-1]*carry_forward[(k-1)*num_dims+j];
+        }
+    }
+
+    // Apply forward coupling, then backward substitution local to each chunk
+    pool.parallel_for(num_partitions, num_threads, [&](const std::size_t k)
+    {
+        std::size_t s = k*size, e = std::min(num_points, s + size);
+        T factor = 1.0;
+        for(std::size_t i = s; i < e && k > 0; i++)
+        {
+            factor *= -f[i];
+            if(factor == 0) break;
+            for(std::size_t j = 0; j < num_dims; j++)
+            {
+                d[i*num_dims+j] = d[i*num_dims+j] + factor*carry_forward[k*num_dims+j];
+            }
+        }
+
+        factor = 1.0;
+        for(std::size_t i = e; i-- > s;)
+        {
+            factor *= -c[i]*inv_b[i];
+            for(std::size_t j = 0; j < num_dims; j++)
             {
-                d[i*num_dims+j] = d[i*num_dims+j] - k*u[i];
+                T next = i + 1 < e ? d[(i+1)*num_dims+j] : 0.0;
+                d[i*num_dims+j] = (d[i*num_dims+j] - c[i]*next)*inv_b[i];
             }
         }
+        h[k] = factor;
+    });
+
+    // Reduced system, first solution row of the following chunk
+    for(std::size_t j = 0; j < num_dims; j++) carry_backward[(num_partitions-1)*num_dims+j] = 0.0;
+    for(std::size_t k = num_partitions - 1; k-- > 0;)
+    {
+        std::size_t first = (k+1)*size;
+        for(std::size_t j = 0; j < num_dims; j++)
+        {
+            carry_backward[k*num_dims+j] = d[first*num_dims+j] + h[k+1]*carry_backward[(k+1)*num_dims+j];
+        }
+    }
+
+    // Sherman-Morrison weights, needs the final first and last row
+    if(factorization.is_perturbed)
+    {
+        for(std::size_t j = 0; j < num_dims; j++)
+        {
+            T first = d[j] + h[0]*carry_backward[j];
+            T last = d[(num_points-1)*num_dims+j];
+            weights[j] = (first - last*factorization.vn)*factorization.inv_vq;
+        }
     }
+
+    // Apply backward coupling and Sherman-Morrison correction
+    pool.parallel_for(num_partitions, num_threads, [&](const std::size_t k)
+    {
+        std::size_t s = k*size, e = std::min(num_points, s + size);
+        T factor = 1.0;
+        for(std::size_t i = e; i-- > s && k + 1 < num_partitions;)
+        {
+            factor *= -c[i]*inv_b[i];
+            if(factor == 0) break;
+            for(std::size_t j = 0; j < num_dims; j++)
+            {
+                d[i*num_dims+j] = d[i*num_dims+j] + factor*carry_backward[k*num_dims+j];
+            }
+        }
+
+        if(factorization.is_perturbed)
+        {
+            const internal::StorageType<T, NumPoints> &q = factorization.q;
+            for(std::size_t i = s; i < e; i++)
+            {
+                for(std::size_t j = 0; j < num_dims; j++)
+                {
+                    d[i*num_dims+j] = d[i*num_dims+j] - weights[j]*q[i];
+                }
+            }
+        }
+    });
+
+    internal::extrapolate_not_a_knot(factorization.left_not_a_knot, factorization.right_not_a_knot,
+        num_points, num_dims, num_dims, d);
 }
 
-} // namespace: parametric_cubic_spline
\ No newline at end of file
+} // namespace: parametric_cubic_spline
@@ -0,0 +1,603 @@
+/*
+ * MIT License
+ *
+ * Parametric Cubic Spline Library
+ * Copyright (c) 2021-, Michael Heidingsfeld
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+#if defined(__AVX2__) || defined(__AVX512F__)
+#include <immintrin.h>
+#endif
+
+namespace parametric_cubic_spline {
+
+namespace internal {
+
+    /**
+     * Vectorized evaluation of cached power-basis coefficients
+     *
+     * Evaluates as many positions as fit into full SIMD registers and returns
+     * their number, the remainder is left to the scalar path. Coefficients
+     * are grouped into blocks of block_width dimensions, see LayoutTraits. Segment index
+     * and local parameter are computed branchless by clamping the scaled
+     * position to [0, num_points-2] before truncation. The generic version
+     * handles no positions.
+     */
+    template<typename T>
+    struct CoefficientKernel
+    {
+        static inline std::size_t eval(
+            const T *, std::size_t, std::size_t, std::size_t, const T *, std::size_t, T *)
+        {
+            return 0;
+        }
+    };
+
+    /**
+     * Row operations of the substitution sweeps
+     *
+     * Updates all columns of one row of the right-hand side at once. Columns
+     * are the dimensions of a spline, or the interleaved dimensions of many
+     * splines in set_batch(), which then fill the SIMD registers.
+     */
+    template<typename T>
+    struct SweepKernel
+    {
+        // row = row - f*prev
+        static inline void eliminate(T *row, const T *prev, const T f, std::size_t n)
+        {
+            for(std::size_t j = 0; j < n; j++) row[j] = row[j] - f*prev[j];
+        }
+
+        // row = (row - c*next)*inv_b
+        static inline void substitute(T *row, const T *next, const T c, const T inv_b, std::size_t n)
+        {
+            for(std::size_t j = 0; j < n; j++) row[j] = (row[j] - c*next[j])*inv_b;
+        }
+    };
+
+    /**
+     * Evaluation of one segment at t over a run of contiguous dimensions
+     *
+     * Points and moments of both segment ends are read row-wise, hence many
+     * dimensions fill the SIMD registers without gathers. Same arithmetic as
+     * the power basis followed by the Horner scheme.
+     */
+    template<typename T>
+    inline void eval_segment(const T *p0, const T *p1, const T *m0, const T *m1,
+        const T t, std::size_t n, T *out)
+    {
+        for(std::size_t j = 0; j < n; j++)
+        {
+            const T b = (p1[j] - p0[j]) - T(1.0/6.0)*(T(2.0)*m0[j] + m1[j]);
+            const T c = T(0.5)*m0[j];
+            const T d = T(1.0/6.0)*(m1[j] - m0[j]);
+            out[j] = ((d*t + c)*t + b)*t + p0[j];
+        }
+    }
+
+    template<typename T>
+    struct SegmentKernel
+    {
+        static inline void eval(const T *p0, const T *p1, const T *m0, const T *m1,
+            const T t, std::size_t n, T *out)
+        {
+            eval_segment(p0, p1, m0, m1, t, n, out);
+        }
+    };
+
+    /**
+     * Index range check for 32 bit gather instructions
+     */
+    inline bool fits_gather_index(std::size_t num_points, std::size_t num_dims)
+    {
+        return 4*num_points*num_dims <= static_cast<std::size_t>(std::numeric_limits<std::int32_t>::max());
+    }
+
+#if defined(__AVX512F__)
+
+    // Zero-masked variants throughout, the unmasked intrinsics trigger
+    // spurious -Wmaybe-uninitialized warnings on some compilers
+    inline __m512d gather(const double *base, __m256i idx)
+    {
+        return _mm512_mask_i32gather_pd(_mm512_setzero_pd(), 0xFF, idx, base, 8);
+    }
+    inline __m512 gather(const float *base, __m512i idx)
+    {
+        return _mm512_mask_i32gather_ps(_mm512_setzero_ps(), 0xFFFF, idx, base, 4);
+    }
+    inline __m512d clamp(__m512d x, __m512d lower, __m512d upper)
+    {
+        return _mm512_maskz_min_pd(0xFF, _mm512_maskz_max_pd(0xFF, x, lower), upper);
+    }
+    inline __m512 clamp(__m512 x, __m512 lower, __m512 upper)
+    {
+        return _mm512_maskz_min_ps(0xFFFF, _mm512_maskz_max_ps(0xFFFF, x, lower), upper);
+    }
+
+    /**
+     * AVX-512, 8 positions per instruction
+     */
+    template<>
+    struct CoefficientKernel<double>
+    {
+        static inline std::size_t eval(
+            const double *coeffs,
+            std::size_t num_points,
+            std::size_t num_dims,
+            std::size_t block_width,
+            const double *pos,
+            std::size_t num_pos,
+            double *out)
+        {
+            const std::size_t width = 8;
+            if(!fits_gather_index(num_points, (num_dims + block_width - 1)/block_width*block_width)) return 0;
+
+            const __m512d scale = _mm512_set1_pd(double(num_points - 1));
+            const __m512d lower = _mm512_setzero_pd();
+            const __m512d upper = _mm512_set1_pd(double(num_points - 2));
+            const __m256i stride = _mm256_set1_epi32(int(4*block_width));
+            alignas(64) double buffer[width];
+
+            std::size_t p = 0;
+            for(; p + width <= num_pos; p += width)
+            {
+                __m512d s = _mm512_mul_pd(_mm512_loadu_pd(pos + p), scale);
+                __m256i i = _mm512_maskz_cvttpd_epi32(0xFF, clamp(s, lower, upper));
+                __m512d t = _mm512_sub_pd(s, _mm512_maskz_cvtepi32_pd(0xFF, i));
+                __m256i idx = _mm256_mullo_epi32(i, stride);
+                for(std::size_t j = 0; j < num_dims; j++)
+                {
+                    const double *c = coeffs + 4*((j/block_width)*(num_points-1)*block_width + j%block_width);
+                    __m512d r = gather(c + 3, idx);
+                    r = _mm512_fmadd_pd(r, t, gather(c + 2, idx));
+                    r = _mm512_fmadd_pd(r, t, gather(c + 1, idx));
+                    r = _mm512_fmadd_pd(r, t, gather(c + 0, idx));
+                    _mm512_store_pd(buffer, r);
+                    for(std::size_t l = 0; l < width; l++) out[(p+l)*num_dims+j] = buffer[l];
+                }
+            }
+            return p;
+        }
+    };
+
+    /**
+     * AVX-512, 16 positions per instruction
+     */
+    template<>
+    struct CoefficientKernel<float>
+    {
+        static inline std::size_t eval(
+            const float *coeffs,
+            std::size_t num_points,
+            std::size_t num_dims,
+            std::size_t block_width,
+            const float *pos,
+            std::size_t num_pos,
+            float *out)
+        {
+            const std::size_t width = 16;
+            if(!fits_gather_index(num_points, (num_dims + block_width - 1)/block_width*block_width)) return 0;
+
+            const __m512 scale = _mm512_set1_ps(float(num_points - 1));
+            const __m512 lower = _mm512_setzero_ps();
+            const __m512 upper = _mm512_set1_ps(float(num_points - 2));
+            const __m512i stride = _mm512_set1_epi32(int(4*block_width));
+            alignas(64) float buffer[width];
+
+            std::size_t p = 0;
+            for(; p + width <= num_pos; p += width)
+            {
+                __m512 s = _mm512_mul_ps(_mm512_loadu_ps(pos + p), scale);
+                __m512i i = _mm512_maskz_cvttps_epi32(0xFFFF, clamp(s, lower, upper));
+                __m512 t = _mm512_sub_ps(s, _mm512_maskz_cvtepi32_ps(0xFFFF, i));
+                __m512i idx = _mm512_mullo_epi32(i, stride);
+                for(std::size_t j = 0; j < num_dims; j++)
+                {
+                    const float *c = coeffs + 4*((j/block_width)*(num_points-1)*block_width + j%block_width);
+                    __m512 r = gather(c + 3, idx);
+                    r = _mm512_fmadd_ps(r, t, gather(c + 2, idx));
+                    r = _mm512_fmadd_ps(r, t, gather(c + 1, idx));
+                    r = _mm512_fmadd_ps(r, t, gather(c + 0, idx));
+                    _mm512_store_ps(buffer, r);
+                    for(std::size_t l = 0; l < width; l++) out[(p+l)*num_dims+j] = buffer[l];
+                }
+            }
+            return p;
+        }
+    };
+
+    /**
+     * AVX-512, 8 columns per instruction
+     */
+    template<>
+    struct SweepKernel<double>
+    {
+        static inline void eliminate(double *row, const double *prev, const double f, std::size_t n)
+        {
+            const __m512d vf = _mm512_set1_pd(f);
+            std::size_t j = 0;
+            for(; j + 8 <= n; j += 8)
+            {
+                _mm512_storeu_pd(row + j, _mm512_fnmadd_pd(vf, _mm512_loadu_pd(prev + j), _mm512_loadu_pd(row + j)));
+            }
+            for(; j < n; j++) row[j] = row[j] - f*prev[j];
+        }
+
+        static inline void substitute(double *row, const double *next, const double c, const double inv_b, std::size_t n)
+        {
+            const __m512d vc = _mm512_set1_pd(c);
+            const __m512d vinv_b = _mm512_set1_pd(inv_b);
+            std::size_t j = 0;
+            for(; j + 8 <= n; j += 8)
+            {
+                _mm512_storeu_pd(row + j, _mm512_mul_pd(_mm512_fnmadd_pd(vc, _mm512_loadu_pd(next + j), _mm512_loadu_pd(row + j)), vinv_b));
+            }
+            for(; j < n; j++) row[j] = (row[j] - c*next[j])*inv_b;
+        }
+    };
+
+    /**
+     * AVX-512, 16 columns per instruction
+     */
+    template<>
+    struct SweepKernel<float>
+    {
+        static inline void eliminate(float *row, const float *prev, const float f, std::size_t n)
+        {
+            const __m512 vf = _mm512_set1_ps(f);
+            std::size_t j = 0;
+            for(; j + 16 <= n; j += 16)
+            {
+                _mm512_storeu_ps(row + j, _mm512_fnmadd_ps(vf, _mm512_loadu_ps(prev + j), _mm512_loadu_ps(row + j)));
+            }
+            for(; j < n; j++) row[j] = row[j] - f*prev[j];
+        }
+
+        static inline void substitute(float *row, const float *next, const float c, const float inv_b, std::size_t n)
+        {
+            const __m512 vc = _mm512_set1_ps(c);
+            const __m512 vinv_b = _mm512_set1_ps(inv_b);
+            std::size_t j = 0;
+            for(; j + 16 <= n; j += 16)
+            {
+                _mm512_storeu_ps(row + j, _mm512_mul_ps(_mm512_fnmadd_ps(vc, _mm512_loadu_ps(next + j), _mm512_loadu_ps(row + j)), vinv_b));
+            }
+            for(; j < n; j++) row[j] = (row[j] - c*next[j])*inv_b;
+        }
+    };
+
+    /**
+     * AVX-512, 8 dimensions per instruction
+     */
+    template<>
+    struct SegmentKernel<double>
+    {
+        static inline void eval(const double *p0, const double *p1, const double *m0, const double *m1,
+            const double t, std::size_t n, double *out)
+        {
+            const __m512d vt = _mm512_set1_pd(t);
+            const __m512d sixth = _mm512_set1_pd(double(1.0/6.0));
+            const __m512d half = _mm512_set1_pd(double(0.5));
+            std::size_t j = 0;
+            for(; j + 8 <= n; j += 8)
+            {
+                const __m512d vp0 = _mm512_loadu_pd(p0 + j);
+                const __m512d vm0 = _mm512_loadu_pd(m0 + j);
+                const __m512d vm1 = _mm512_loadu_pd(m1 + j);
+                const __m512d b = _mm512_sub_pd(_mm512_sub_pd(_mm512_loadu_pd(p1 + j), vp0),
+                    _mm512_mul_pd(sixth, _mm512_add_pd(_mm512_add_pd(vm0, vm0), vm1)));
+                const __m512d c = _mm512_mul_pd(half, vm0);
+                const __m512d d = _mm512_mul_pd(sixth, _mm512_sub_pd(vm1, vm0));
+                __m512d r = _mm512_fmadd_pd(d, vt, c);
+                r = _mm512_fmadd_pd(r, vt, b);
+                r = _mm512_fmadd_pd(r, vt, vp0);
+                _mm512_storeu_pd(out + j, r);
+            }
+            eval_segment(p0 + j, p1 + j, m0 + j, m1 + j, t, n - j, out + j);
+        }
+    };
+
+    /**
+     * AVX-512, 16 dimensions per instruction
+     */
+    template<>
+    struct SegmentKernel<float>
+    {
+        static inline void eval(const float *p0, const float *p1, const float *m0, const float *m1,
+            const float t, std::size_t n, float *out)
+        {
+            const __m512 vt = _mm512_set1_ps(t);
+            const __m512 sixth = _mm512_set1_ps(float(1.0/6.0));
+            const __m512 half = _mm512_set1_ps(float(0.5));
+            std::size_t j = 0;
+            for(; j + 16 <= n; j += 16)
+            {
+                const __m512 vp0 = _mm512_loadu_ps(p0 + j);
+                const __m512 vm0 = _mm512_loadu_ps(m0 + j);
+                const __m512 vm1 = _mm512_loadu_ps(m1 + j);
+                const __m512 b = _mm512_sub_ps(_mm512_sub_ps(_mm512_loadu_ps(p1 + j), vp0),
+                    _mm512_mul_ps(sixth, _mm512_add_ps(_mm512_add_ps(vm0, vm0), vm1)));
+                const __m512 c = _mm512_mul_ps(half, vm0);
+                const __m512 d = _mm512_mul_ps(sixth, _mm512_sub_ps(vm1, vm0));
+                __m512 r = _mm512_fmadd_ps(d, vt, c);
+                r = _mm512_fmadd_ps(r, vt, b);
+                r = _mm512_fmadd_ps(r, vt, vp0);
+                _mm512_storeu_ps(out + j, r);
+            }
+            eval_segment(p0 + j, p1 + j, m0 + j, m1 + j, t, n - j, out + j);
+        }
+    };
+
+#elif defined(__AVX2__)
+
+#if defined(__FMA__)
+    inline __m256d madd(__m256d a, __m256d b, __m256d c) { return _mm256_fmadd_pd(a, b, c); }
+    inline __m256 madd(__m256 a, __m256 b, __m256 c) { return _mm256_fmadd_ps(a, b, c); }
+#else
+    inline __m256d madd(__m256d a, __m256d b, __m256d c) { return _mm256_add_pd(_mm256_mul_pd(a, b), c); }
+    inline __m256 madd(__m256 a, __m256 b, __m256 c) { return _mm256_add_ps(_mm256_mul_ps(a, b), c); }
+#endif
+#if defined(__FMA__)
+    inline __m256d nmadd(__m256d a, __m256d b, __m256d c) { return _mm256_fnmadd_pd(a, b, c); }
+    inline __m256 nmadd(__m256 a, __m256 b, __m256 c) { return _mm256_fnmadd_ps(a, b, c); }
+#else
+    inline __m256d nmadd(__m256d a, __m256d b, __m256d c) { return _mm256_sub_pd(c, _mm256_mul_pd(a, b)); }
+    inline __m256 nmadd(__m256 a, __m256 b, __m256 c) { return _mm256_sub_ps(c, _mm256_mul_ps(a, b)); }
+#endif
+
+    // Masked gathers with zero source, the unmasked intrinsics trigger
+    // spurious -Wmaybe-uninitialized warnings on some compilers
+    inline __m256d gather(const double *base, __m128i idx)
+    {
+        return _mm256_mask_i32gather_pd(_mm256_setzero_pd(), base, idx,
+            _mm256_castsi256_pd(_mm256_set1_epi64x(-1)), 8);
+    }
+    inline __m256 gather(const float *base, __m256i idx)
+    {
+        return _mm256_mask_i32gather_ps(_mm256_setzero_ps(), base, idx,
+            _mm256_castsi256_ps(_mm256_set1_epi32(-1)), 4);
+    }
+
+    /**
+     * AVX2, 4 positions per instruction
+     */
+    template<>
+    struct CoefficientKernel<double>
+    {
+        static inline std::size_t eval(
+            const double *coeffs,
+            std::size_t num_points,
+            std::size_t num_dims,
+            std::size_t block_width,
+            const double *pos,
+            std::size_t num_pos,
+            double *out)
+        {
+            const std::size_t width = 4;
+            if(!fits_gather_index(num_points, (num_dims + block_width - 1)/block_width*block_width)) return 0;
+
+            const __m256d scale = _mm256_set1_pd(double(num_points - 1));
+            const __m256d lower = _mm256_setzero_pd();
+            const __m256d upper = _mm256_set1_pd(double(num_points - 2));
+            const __m128i stride = _mm_set1_epi32(int(4*block_width));
+            alignas(32) double buffer[width];
+
+            std::size_t p = 0;
+            for(; p + width <= num_pos; p += width)
+            {
+                __m256d s = _mm256_mul_pd(_mm256_loadu_pd(pos + p), scale);
+                __m128i i = _mm256_cvttpd_epi32(_mm256_min_pd(_mm256_max_pd(s, lower), upper));
+                __m256d t = _mm256_sub_pd(s, _mm256_cvtepi32_pd(i));
+                __m128i idx = _mm_mullo_epi32(i, stride);
+                for(std::size_t j = 0; j < num_dims; j++)
+                {
+                    const double *c = coeffs + 4*((j/block_width)*(num_points-1)*block_width + j%block_width);
+                    __m256d r = gather(c + 3, idx);
+                    r = madd(r, t, gather(c + 2, idx));
+                    r = madd(r, t, gather(c + 1, idx));
+                    r = madd(r, t, gather(c + 0, idx));
+                    _mm256_store_pd(buffer, r);
+                    for(std::size_t l = 0; l < width; l++) out[(p+l)*num_dims+j] = buffer[l];
+                }
+            }
+            return p;
+        }
+    };
+
+    /**
+     * AVX2, 8 positions per instruction
+     */
+    template<>
+    struct CoefficientKernel<float>
+    {
+        static inline std::size_t eval(
+            const float *coeffs,
+            std::size_t num_points,
+            std::size_t num_dims,
+            std::size_t block_width,
+            const float *pos,
+            std::size_t num_pos,
+            float *out)
+        {
+            const std::size_t width = 8;
+            if(!fits_gather_index(num_points, (num_dims + block_width - 1)/block_width*block_width)) return 0;
+
+            const __m256 scale = _mm256_set1_ps(float(num_points - 1));
+            const __m256 lower = _mm256_setzero_ps();
+            const __m256 upper = _mm256_set1_ps(float(num_points - 2));
+            const __m256i stride = _mm256_set1_epi32(int(4*block_width));
+            alignas(32) float buffer[width];
+
+            std::size_t p = 0;
+            for(; p + width <= num_pos; p += width)
+            {
+                __m256 s = _mm256_mul_ps(_mm256_loadu_ps(pos + p), scale);
+                __m256i i = _mm256_cvttps_epi32(_mm256_min_ps(_mm256_max_ps(s, lower), upper));
+                __m256 t = _mm256_sub_ps(s, _mm256_cvtepi32_ps(i));
+                __m256i idx = _mm256_mullo_epi32(i, stride);
+                for(std::size_t j = 0; j < num_dims; j++)
+                {
+                    const float *c = coeffs + 4*((j/block_width)*(num_points-1)*block_width + j%block_width);
+                    __m256 r = gather(c + 3, idx);
+                    r = madd(r, t, gather(c + 2, idx));
+                    r = madd(r, t, gather(c + 1, idx));
+                    r = madd(r, t, gather(c + 0, idx));
+                    _mm256_store_ps(buffer, r);
+                    for(std::size_t l = 0; l < width; l++) out[(p+l)*num_dims+j] = buffer[l];
+                }
+            }
+            return p;
+        }
+    };
+
+    /**
+     * AVX2, 4 columns per instruction
+     */
+    template<>
+    struct SweepKernel<double>
+    {
+        static inline void eliminate(double *row, const double *prev, const double f, std::size_t n)
+        {
+            const __m256d vf = _mm256_set1_pd(f);
+            std::size_t j = 0;
+            for(; j + 4 <= n; j += 4)
+            {
+                _mm256_storeu_pd(row + j, nmadd(vf, _mm256_loadu_pd(prev + j), _mm256_loadu_pd(row + j)));
+            }
+            for(; j < n; j++) row[j] = row[j] - f*prev[j];
+        }
+
+        static inline void substitute(double *row, const double *next, const double c, const double inv_b, std::size_t n)
+        {
+            const __m256d vc = _mm256_set1_pd(c);
+            const __m256d vinv_b = _mm256_set1_pd(inv_b);
+            std::size_t j = 0;
+            for(; j + 4 <= n; j += 4)
+            {
+                _mm256_storeu_pd(row + j, _mm256_mul_pd(nmadd(vc, _mm256_loadu_pd(next + j), _mm256_loadu_pd(row + j)), vinv_b));
+            }
+            for(; j < n; j++) row[j] = (row[j] - c*next[j])*inv_b;
+        }
+    };
+
+    /**
+     * AVX2, 8 columns per instruction
+     */
+    template<>
+    struct SweepKernel<float>
+    {
+        static inline void eliminate(float *row, const float *prev, const float f, std::size_t n)
+        {
+            const __m256 vf = _mm256_set1_ps(f);
+            std::size_t j = 0;
+            for(; j + 8 <= n; j += 8)
+            {
+                _mm256_storeu_ps(row + j, nmadd(vf, _mm256_loadu_ps(prev + j), _mm256_loadu_ps(row + j)));
+            }
+            for(; j < n; j++) row[j] = row[j] - f*prev[j];
+        }
+
+        static inline void substitute(float *row, const float *next, const float c, const float inv_b, std::size_t n)
+        {
+            const __m256 vc = _mm256_set1_ps(c);
+            const __m256 vinv_b = _mm256_set1_ps(inv_b);
+            std::size_t j = 0;
+            for(; j + 8 <= n; j += 8)
+            {
+                _mm256_storeu_ps(row + j, _mm256_mul_ps(nmadd(vc, _mm256_loadu_ps(next + j), _mm256_loadu_ps(row + j)), vinv_b));
+            }
+            for(; j < n; j++) row[j] = (row[j] - c*next[j])*inv_b;
+        }
+    };
+
+    /**
+     * AVX2, 4 dimensions per instruction
+     */
+    template<>
+    struct SegmentKernel<double>
+    {
+        static inline void eval(const double *p0, const double *p1, const double *m0, const double *m1,
+            const double t, std::size_t n, double *out)
+        {
+            const __m256d vt = _mm256_set1_pd(t);
+            const __m256d sixth = _mm256_set1_pd(double(1.0/6.0));
+            const __m256d half = _mm256_set1_pd(double(0.5));
+            std::size_t j = 0;
+            for(; j + 4 <= n; j += 4)
+            {
+                const __m256d vp0 = _mm256_loadu_pd(p0 + j);
+                const __m256d vm0 = _mm256_loadu_pd(m0 + j);
+                const __m256d vm1 = _mm256_loadu_pd(m1 + j);
+                const __m256d b = _mm256_sub_pd(_mm256_sub_pd(_mm256_loadu_pd(p1 + j), vp0),
+                    _mm256_mul_pd(sixth, _mm256_add_pd(_mm256_add_pd(vm0, vm0), vm1)));
+                const __m256d c = _mm256_mul_pd(half, vm0);
+                const __m256d d = _mm256_mul_pd(sixth, _mm256_sub_pd(vm1, vm0));
+                __m256d r = madd(d, vt, c);
+                r = madd(r, vt, b);
+                r = madd(r, vt, vp0);
+                _mm256_storeu_pd(out + j, r);
+            }
+            eval_segment(p0 + j, p1 + j, m0 + j, m1 + j, t, n - j, out + j);
+        }
+    };
+
+    /**
+     * AVX2, 8 dimensions per instruction
+     */
+    template<>
+    struct SegmentKernel<float>
+    {
+        static inline void eval(const float *p0, const float *p1, const float *m0, const float *m1,
+            const float t, std::size_t n, float *out)
+        {
+            const __m256 vt = _mm256_set1_ps(t);
+            const __m256 sixth = _mm256_set1_ps(float(1.0/6.0));
+            const __m256 half = _mm256_set1_ps(float(0.5));
+            std::size_t j = 0;
+            for(; j + 8 <= n; j += 8)
+            {
+                const __m256 vp0 = _mm256_loadu_ps(p0 + j);
+                const __m256 vm0 = _mm256_loadu_ps(m0 + j);
+                const __m256 vm1 = _mm256_loadu_ps(m1 + j);
+                const __m256 b = _mm256_sub_ps(_mm256_sub_ps(_mm256_loadu_ps(p1 + j), vp0),
+                    _mm256_mul_ps(sixth, _mm256_add_ps(_mm256_add_ps(vm0, vm0), vm1)));
+                const __m256 c = _mm256_mul_ps(half, vm0);
+                const __m256 d = _mm256_mul_ps(sixth, _mm256_sub_ps(vm1, vm0));
+                __m256 r = madd(d, vt, c);
+                r = madd(r, vt, b);
+                r = madd(r, vt, vp0);
+                _mm256_storeu_ps(out + j, r);
+            }
+            eval_segment(p0 + j, p1 + j, m0 + j, m1 + j, t, n - j, out + j);
+        }
+    };
+
+#endif
+
+} // namespace: internal
+
+} // namespace: parametric_cubic_spline
@@ -0,0 +1,180 @@
+/*
+ * MIT License
+ *
+ * Parametric Cubic Spline Library
+ * Copyright (c) 2021-, Michael Heidingsfeld
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#pragma once
+
+#include <algorithm>
+#include <type_traits>
+
+namespace parametric_cubic_spline {
+
+namespace internal {
+
+// Evaluates spline id of an arena of power-basis coefficients, where the
+// coefficients of spline id occupy [offsets[id], offsets[id+1])
+template<typename T, typename Offset>
+inline void eval_packed(
+    const T *coefficients,
+    const Offset *offsets,
+    const std::size_t num_dims,
+    const std::size_t id,
+    const T pos,
+    T *out_point
+)
+{
+    // Same segment lookup as Spline, positions outside of [0, 1] are
+    // extrapolated from the first or last segment
+    const std::size_t num_segments = static_cast<std::size_t>(offsets[id+1] - offsets[id])/(4*num_dims);
+    T s = pos * num_segments;
+    std::size_t i = s > 0 ? static_cast<std::size_t>(s) : 0;
+    if(i > num_segments - 1) i = num_segments - 1;
+    T t = s - i;
+
+    const T *coeffs = &coefficients[offsets[id] + 4*i*num_dims];
+    for(std::size_t j = 0; j < num_dims; j++, coeffs += 4)
+    {
+        *out_point++ = ((coeffs[3]*t + coeffs[2])*t + coeffs[1])*t + coeffs[0];
+    }
+}
+
+template<typename T, typename Offset>
+inline void eval_packed(
+    const T *coefficients,
+    const Offset *offsets,
+    const std::size_t num_dims,
+    const std::size_t *ids,
+    const T *pos,
+    const std::size_t num_queries,
+    T *out_points,
+    const std::size_t num_threads
+)
+{
+    const std::size_t num_chunks = (num_queries + position_chunk - 1)/position_chunk;
+    const bool is_parallel = num_queries*num_dims >= min_parallel_work;
+    ThreadPool::instance().parallel_for(num_chunks, is_parallel ? num_threads : 1,
+        [&](const std::size_t k)
+        {
+            const std::size_t end = std::min(num_queries, (k+1)*position_chunk);
+            for(std::size_t q = k*position_chunk; q < end; q++)
+            {
+                eval_packed(coefficients, offsets, num_dims, ids[q], pos[q], &out_points[q*num_dims]);
+            }
+        });
+}
+
+} // namespace: internal
+
+template<typename T>
+SplineBank<T>::SplineBank(const std::size_t num_dims) :
+    num_dims_(num_dims),
+    offsets_(1, 0)
+{
+    static_assert(std::is_floating_point<T>::value, "T must be a floating point type.");
+    solver_.enable_coefficient_cache();
+    solver_.enable_factorization_cache();
+}
+
+template<typename T>
+std::size_t SplineBank<T>::add(
+    const T *points,
+    const std::size_t num_points,
+    const BoundaryCondition left_bc,
+    const BoundaryCondition right_bc,
+    const T *left_tangent,
+    const T *right_tangent
+)
+{
+    // Splines of equal length share their factorization through the cache
+    solver_.set(points, num_points, num_dims_, left_bc, right_bc, left_tangent, right_tangent);
+    const T *coeffs = solver_.coefficients_.data();
+    coefficients_.insert(coefficients_.end(), coeffs, coeffs + 4*(num_points - 1)*num_dims_);
+    offsets_.push_back(coefficients_.size());
+    return offsets_.size() - 2;
+}
+
+template<typename T>
+void SplineBank<T>::reserve(
+    const std::size_t num_splines,
+    const std::size_t num_points
+)
+{
+    offsets_.reserve(num_splines + 1);
+    coefficients_.reserve(4*num_points*num_dims_);
+}
+
+template<typename T>
+void SplineBank<T>::clear()
+{
+    coefficients_.clear();
+    offsets_.resize(1);
+}
+
+template<typename T>
+std::size_t SplineBank<T>::size() const
+{
+    return offsets_.size() - 1;
+}
+
+template<typename T>
+std::size_t SplineBank<T>::num_dims() const
+{
+    return num_dims_;
+}
+
+template<typename T>
+std::size_t SplineBank<T>::num_points(const std::size_t id) const
+{
+    return (offsets_[id+1] - offsets_[id])/(4*num_dims_) + 1;
+}
+
+template<typename T>
+std::size_t SplineBank<T>::memory_footprint() const
+{
+    return coefficients_.capacity()*sizeof(T) + offsets_.capacity()*sizeof(std::size_t);
+}
+
+template<typename T>
+void SplineBank<T>::eval(
+    const std::size_t id,
+    const T pos,
+    T *out_point
+) const
+{
+    internal::eval_packed(coefficients_.data(), offsets_.data(), num_dims_, id, pos, out_point);
+}
+
+template<typename T>
+void SplineBank<T>::eval(
+    const std::size_t *ids,
+    const T *pos,
+    const std::size_t num_queries,
+    T *out_points,
+    const std::size_t num_threads
+) const
+{
+    internal::eval_packed(coefficients_.data(), offsets_.data(), num_dims_,
+        ids, pos, num_queries, out_points, num_threads);
+}
+
+} // namespace: parametric_cubic_spline
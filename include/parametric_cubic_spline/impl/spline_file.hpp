@@ -0,0 +1,332 @@
+/*
+ * MIT License
+ *
+ * Parametric Cubic Spline Library
+ * Copyright (c) 2021-, Michael Heidingsfeld
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#pragma once
+
+#include <cstring>
+#include <fstream>
+#include <type_traits>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define PARAMETRIC_CUBIC_SPLINE_HAS_MMAP
+#endif
+
+namespace parametric_cubic_spline {
+
+namespace internal {
+
+static const char spline_file_magic[8] = {'P', 'C', 'S', 'P', 'L', 'I', 'N', 'E'};
+static const std::uint32_t spline_file_version = 1;
+static const std::uint32_t spline_file_endian_tag = 0x01020304;
+static const std::uint64_t spline_file_alignment = 64;
+
+inline std::uint64_t align_file_offset(const std::uint64_t offset)
+{
+    return (offset + spline_file_alignment - 1)/spline_file_alignment*spline_file_alignment;
+}
+
+// a*b + c of header fields, false if it does not fit into 64 bits
+inline bool checked_multiply_add(
+    const std::uint64_t a,
+    const std::uint64_t b,
+    const std::uint64_t c,
+    std::uint64_t &result
+)
+{
+    const std::uint64_t max = ~std::uint64_t(0);
+    if(a != 0 && b > max/a) return false;
+    if(a*b > max - c) return false;
+    result = a*b + c;
+    return true;
+}
+
+} // namespace: internal
+
+template<typename T>
+SplineFileWriter<T>::SplineFileWriter(const std::size_t num_dims) :
+    bank_(num_dims)
+{
+}
+
+template<typename T>
+std::size_t SplineFileWriter<T>::add(
+    const T *points,
+    const std::size_t num_points,
+    const BoundaryCondition left_bc,
+    const BoundaryCondition right_bc,
+    const T *left_tangent,
+    const T *right_tangent
+)
+{
+    points_.insert(points_.end(), points, points + num_points*bank_.num_dims());
+    return bank_.add(points, num_points, left_bc, right_bc, left_tangent, right_tangent);
+}
+
+template<typename T>
+std::size_t SplineFileWriter<T>::size() const
+{
+    return bank_.size();
+}
+
+template<typename T>
+bool SplineFileWriter<T>::write(const std::string &path) const
+{
+    using namespace internal;
+
+    SplineFileHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, spline_file_magic, sizeof(header.magic));
+    header.version = spline_file_version;
+    header.endian_tag = spline_file_endian_tag;
+    header.scalar_size = sizeof(T);
+    header.num_dims = static_cast<std::uint32_t>(bank_.num_dims());
+    header.num_splines = bank_.size();
+    header.num_points = points_.size()/bank_.num_dims();
+    header.offsets_offset = align_file_offset(sizeof(SplineFileHeader));
+    header.coefficients_offset = align_file_offset(header.offsets_offset + (header.num_splines + 1)*sizeof(std::uint64_t));
+    header.points_offset = align_file_offset(header.coefficients_offset + bank_.coefficients_.size()*sizeof(T));
+    header.file_size = align_file_offset(header.points_offset + points_.size()*sizeof(T));
+
+    const std::vector<std::uint64_t> offsets(bank_.offsets_.begin(), bank_.offsets_.end());
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    const char padding[spline_file_alignment] = {};
+    std::uint64_t position = 0;
+    const auto write_section = [&](const std::uint64_t offset, const void *data, const std::size_t size)
+    {
+        file.write(padding, static_cast<std::streamsize>(offset - position));
+        file.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+        position = offset + size;
+    };
+    write_section(0, &header, sizeof(header));
+    write_section(header.offsets_offset, offsets.data(), offsets.size()*sizeof(std::uint64_t));
+    write_section(header.coefficients_offset, bank_.coefficients_.data(), bank_.coefficients_.size()*sizeof(T));
+    write_section(header.points_offset, points_.data(), points_.size()*sizeof(T));
+    write_section(header.file_size, nullptr, 0);
+    return static_cast<bool>(file.flush());
+}
+
+template<typename T>
+SplineFile<T>::SplineFile() :
+    data_(nullptr),
+    size_(0),
+    mapping_(nullptr),
+    num_dims_(0),
+    num_splines_(0),
+    offsets_(nullptr),
+    coefficients_(nullptr),
+    points_(nullptr)
+{
+    static_assert(std::is_floating_point<T>::value, "T must be a floating point type.");
+}
+
+template<typename T>
+SplineFile<T>::~SplineFile()
+{
+    close();
+}
+
+template<typename T>
+bool SplineFile<T>::open(const std::string &path)
+{
+    close();
+#ifdef PARAMETRIC_CUBIC_SPLINE_HAS_MMAP
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if(fd < 0) return false;
+    struct stat status;
+    if(::fstat(fd, &status) != 0 || status.st_size < static_cast<off_t>(sizeof(internal::SplineFileHeader)))
+    {
+        ::close(fd);
+        return false;
+    }
+    const std::size_t size = static_cast<std::size_t>(status.st_size);
+    void *mapping = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if(mapping == MAP_FAILED) return false;
+    if(!attach(mapping, size))
+    {
+        ::munmap(mapping, size);
+        return false;
+    }
+    mapping_ = mapping;
+    return true;
+#else
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if(!file) return false;
+    const std::size_t size = static_cast<std::size_t>(file.tellg());
+    buffer_.resize((size + sizeof(std::uint64_t) - 1)/sizeof(std::uint64_t));
+    file.seekg(0);
+    if(!file.read(reinterpret_cast<char*>(buffer_.data()), static_cast<std::streamsize>(size))) return false;
+    return attach(buffer_.data(), size);
+#endif
+}
+
+template<typename T>
+bool SplineFile<T>::open(const void *data, const std::size_t size)
+{
+    close();
+    return attach(data, size);
+}
+
+template<typename T>
+bool SplineFile<T>::attach(const void *data, const std::size_t size)
+{
+    using namespace internal;
+
+    if(size < sizeof(SplineFileHeader) || reinterpret_cast<std::uintptr_t>(data) % alignof(std::uint64_t) != 0) return false;
+    SplineFileHeader header;
+    std::memcpy(&header, data, sizeof(header));
+    if(std::memcmp(header.magic, spline_file_magic, sizeof(header.magic)) != 0 ||
+       header.version != spline_file_version ||
+       header.endian_tag != spline_file_endian_tag ||
+       header.scalar_size != sizeof(T) ||
+       header.num_dims == 0 ||
+       header.file_size > size)
+    {
+        return false;
+    }
+
+    // sections must be aligned and lie within the file, sizes are checked
+    // for overflow as the header may be corrupted or hostile
+    std::uint64_t num_coefficients, offsets_end, coefficients_end, points_end, num_values;
+    if(header.num_splines > header.num_points/2 ||
+       !checked_multiply_add(4*std::uint64_t(header.num_dims), header.num_points - header.num_splines, 0, num_coefficients) ||
+       !checked_multiply_add(header.num_splines, sizeof(std::uint64_t), sizeof(std::uint64_t), offsets_end) ||
+       !checked_multiply_add(num_coefficients, sizeof(T), 0, coefficients_end) ||
+       !checked_multiply_add(header.num_points, header.num_dims, 0, num_values) ||
+       !checked_multiply_add(num_values, sizeof(T), 0, points_end) ||
+       !checked_multiply_add(1, offsets_end, header.offsets_offset, offsets_end) ||
+       !checked_multiply_add(1, coefficients_end, header.coefficients_offset, coefficients_end) ||
+       !checked_multiply_add(1, points_end, header.points_offset, points_end))
+    {
+        return false;
+    }
+    if(header.offsets_offset % spline_file_alignment != 0 ||
+       header.coefficients_offset % spline_file_alignment != 0 ||
+       header.points_offset % spline_file_alignment != 0 ||
+       offsets_end > header.coefficients_offset ||
+       coefficients_end > header.points_offset ||
+       points_end > header.file_size)
+    {
+        return false;
+    }
+
+    // Every spline has at least one segment, all within the coefficients,
+    // which also keeps its points within the points section
+    const unsigned char *bytes = static_cast<const unsigned char*>(data);
+    const std::uint64_t *offsets = reinterpret_cast<const std::uint64_t*>(bytes + header.offsets_offset);
+    const std::uint64_t segment_size = 4*std::uint64_t(header.num_dims);
+    if(offsets[0] != 0 || offsets[header.num_splines] != num_coefficients) return false;
+    for(std::uint64_t k = 0; k < header.num_splines; k++)
+    {
+        if(offsets[k+1] <= offsets[k] || offsets[k+1] % segment_size != 0) return false;
+    }
+
+    data_ = bytes;
+    size_ = size;
+    num_dims_ = header.num_dims;
+    num_splines_ = header.num_splines;
+    offsets_ = offsets;
+    coefficients_ = reinterpret_cast<const T*>(bytes + header.coefficients_offset);
+    points_ = reinterpret_cast<const T*>(bytes + header.points_offset);
+    return true;
+}
+
+template<typename T>
+void SplineFile<T>::close()
+{
+#ifdef PARAMETRIC_CUBIC_SPLINE_HAS_MMAP
+    if(mapping_) ::munmap(mapping_, size_);
+#endif
+    mapping_ = nullptr;
+    buffer_.clear();
+    buffer_.shrink_to_fit();
+    data_ = nullptr;
+    size_ = 0;
+    num_dims_ = 0;
+    num_splines_ = 0;
+    offsets_ = nullptr;
+    coefficients_ = nullptr;
+    points_ = nullptr;
+}
+
+template<typename T>
+bool SplineFile<T>::is_open() const
+{
+    return data_ != nullptr;
+}
+
+template<typename T>
+std::size_t SplineFile<T>::size() const
+{
+    return num_splines_;
+}
+
+template<typename T>
+std::size_t SplineFile<T>::num_dims() const
+{
+    return num_dims_;
+}
+
+template<typename T>
+std::size_t SplineFile<T>::num_points(const std::size_t id) const
+{
+    return static_cast<std::size_t>(offsets_[id+1] - offsets_[id])/(4*num_dims_) + 1;
+}
+
+template<typename T>
+const T *SplineFile<T>::points(const std::size_t id) const
+{
+    // every spline has one point more than segments
+    return &points_[offsets_[id]/4 + id*num_dims_];
+}
+
+template<typename T>
+void SplineFile<T>::eval(
+    const std::size_t id,
+    const T pos,
+    T *out_point
+) const
+{
+    internal::eval_packed(coefficients_, offsets_, num_dims_, id, pos, out_point);
+}
+
+template<typename T>
+void SplineFile<T>::eval(
+    const std::size_t *ids,
+    const T *pos,
+    const std::size_t num_queries,
+    T *out_points,
+    const std::size_t num_threads
+) const
+{
+    internal::eval_packed(coefficients_, offsets_, num_dims_,
+        ids, pos, num_queries, out_points, num_threads);
+}
+
+} // namespace: parametric_cubic_spline
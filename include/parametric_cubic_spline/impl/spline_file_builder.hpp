@@ -0,0 +1,293 @@
+/*
+ * MIT License
+ *
+ * Parametric Cubic Spline Library
+ * Copyright (c) 2021-, Michael Heidingsfeld
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#pragma once
+
+#include <algorithm>
+#include <cstring>
+#include <type_traits>
+
+namespace parametric_cubic_spline {
+
+namespace internal {
+
+#ifdef PARAMETRIC_CUBIC_SPLINE_HAS_MMAP
+    /**
+     * Shared mapping of a whole file
+     *
+     * Pages of a shared file mapping are backed by the file, hence releasing
+     * them only drops them from the resident memory of the process, their
+     * contents are read back from the page cache or the file when touched.
+     */
+    class FileMapping
+    {
+        unsigned char *data_;
+        std::size_t size_;
+
+    public:
+        FileMapping() : data_(nullptr), size_(0) {}
+        ~FileMapping() { if(data_) ::munmap(data_, size_); }
+
+        FileMapping(const FileMapping &) = delete;
+        FileMapping &operator=(const FileMapping &) = delete;
+
+        // map an existing file read-only
+        bool open(const std::string &path)
+        {
+            const int fd = ::open(path.c_str(), O_RDONLY);
+            if(fd < 0) return false;
+            struct stat status;
+            if(::fstat(fd, &status) != 0 || status.st_size <= 0)
+            {
+                ::close(fd);
+                return false;
+            }
+            return map(fd, static_cast<std::size_t>(status.st_size), PROT_READ);
+        }
+
+        // create or truncate a file of size bytes and map it for writing, a
+        // temporary file is removed once unmapped. The space is reserved up
+        // front where possible, as a full disk would otherwise raise SIGBUS
+        // on a write through the mapping.
+        bool create(const std::string &path, const std::size_t size, const bool temporary)
+        {
+            const int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+            if(fd < 0) return false;
+            if(temporary) ::unlink(path.c_str());
+#ifdef __APPLE__
+            const bool is_reserved = ::ftruncate(fd, static_cast<off_t>(size)) == 0;
+#else
+            const bool is_reserved = ::posix_fallocate(fd, 0, static_cast<off_t>(size)) == 0;
+#endif
+            if(!is_reserved)
+            {
+                ::close(fd);
+                if(!temporary) ::unlink(path.c_str());
+                return false;
+            }
+            return map(fd, size, PROT_READ | PROT_WRITE);
+        }
+
+        unsigned char *data() const { return data_; }
+        std::size_t size() const { return size_; }
+
+        // drop the pages lying entirely within bytes [begin, end) from the
+        // resident memory, partial pages at either end are kept
+        void release(std::size_t begin, std::size_t end) const
+        {
+            const std::size_t page = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+            begin = (begin + page - 1)/page*page;
+            end = std::min(size_, end)/page*page;
+            if(begin < end) ::madvise(data_ + begin, end - begin, MADV_DONTNEED);
+        }
+
+        // write dirty pages back, false on I/O errors
+        bool sync() const
+        {
+            return ::msync(data_, size_, MS_SYNC) == 0;
+        }
+
+    private:
+        bool map(const int fd, const std::size_t size, const int protection)
+        {
+            void *mapping = ::mmap(nullptr, size, protection, MAP_SHARED, fd, 0);
+            ::close(fd);
+            if(mapping == MAP_FAILED) return false;
+            data_ = static_cast<unsigned char*>(mapping);
+            size_ = size;
+            return true;
+        }
+    };
+#endif
+
+} // namespace: internal
+
+template<typename T>
+SplineFileBuilder<T>::SplineFileBuilder(const std::size_t num_dims) :
+    num_dims_(num_dims),
+    chunk_size_(1 << 16)
+{
+    static_assert(std::is_floating_point<T>::value, "T must be a floating point type.");
+}
+
+template<typename T>
+void SplineFileBuilder<T>::set_chunk_size(const std::size_t num_rows)
+{
+    chunk_size_ = std::max<std::size_t>(num_rows, 1);
+}
+
+template<typename T>
+bool SplineFileBuilder<T>::build(
+    const std::string &input_path,
+    const std::string &output_path,
+    const BoundaryCondition left_bc,
+    const BoundaryCondition right_bc,
+    const T *left_tangent,
+    const T *right_tangent
+) const
+{
+#ifdef PARAMETRIC_CUBIC_SPLINE_HAS_MMAP
+    using namespace internal;
+    typedef Spline<T, Dynamic, Dynamic> Solver;
+
+    // Periodic boundaries couple both ends through the Sherman-Morrison
+    // correction, which would need another sweep
+    if(left_bc == BoundaryCondition::Periodic || right_bc == BoundaryCondition::Periodic) return false;
+
+    const std::size_t num_dims = num_dims_;
+    const std::size_t row_size = num_dims*sizeof(T);
+    FileMapping input;
+    if(num_dims == 0 || !input.open(input_path) || input.size() % row_size != 0) return false;
+    const std::size_t n = input.size()/row_size;
+    if(n < 2) return false;
+    const T *points = reinterpret_cast<const T*>(input.data());
+
+    // Same layout as SplineFileWriter with a single spline
+    SplineFileHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, spline_file_magic, sizeof(header.magic));
+    header.version = spline_file_version;
+    header.endian_tag = spline_file_endian_tag;
+    header.scalar_size = sizeof(T);
+    header.num_dims = static_cast<std::uint32_t>(num_dims);
+    header.num_splines = 1;
+    header.num_points = n;
+    header.offsets_offset = align_file_offset(sizeof(SplineFileHeader));
+    header.coefficients_offset = align_file_offset(header.offsets_offset + 2*sizeof(std::uint64_t));
+    header.points_offset = align_file_offset(header.coefficients_offset + 4*(n-1)*row_size);
+    header.file_size = align_file_offset(header.points_offset + n*row_size);
+
+    // The header is written once the file is complete, until then the file
+    // is rejected by SplineFile
+    FileMapping output;
+    if(!output.create(output_path, header.file_size, false)) return false;
+    const std::uint64_t offsets[2] = {0, 4*(n-1)*num_dims};
+    std::memcpy(output.data() + header.offsets_offset, offsets, sizeof(offsets));
+    T *coefficients = reinterpret_cast<T*>(output.data() + header.coefficients_offset);
+    T *out_points = reinterpret_cast<T*>(output.data() + header.points_offset);
+
+    // Spill: right-hand side, eliminated and then overwritten by the
+    // moments, followed by the inverse pivots
+    FileMapping spill;
+    if(!spill.create(output_path + ".spill", n*(row_size + sizeof(T)), true)) return false;
+    T *d = reinterpret_cast<T*>(spill.data());
+    T *inv_b = d + n*num_dims;
+    const std::size_t inv_b_offset = n*row_size;
+
+    // Forward elimination, the rows before the previous one are released
+    const std::size_t chunk = chunk_size_;
+    T b_prev = 1.0;
+    T c_prev = 0.0;
+    for(std::size_t begin = 0; begin < n; begin += chunk)
+    {
+        const std::size_t end = std::min(n, begin + chunk);
+        Solver::assemble_rhs(points, n, num_dims, left_bc, right_bc, left_tangent, right_tangent,
+            begin, end, 0, num_dims, d, num_dims);
+        for(std::size_t i = begin; i < end; i++)
+        {
+            T a, b, c;
+            moment_row(n, left_bc, right_bc, i, a, b, c);
+            if(i > 0)
+            {
+                const T f = a/b_prev;
+                b = b - f*c_prev;
+                SweepKernel<T>::eliminate(d + i*num_dims, d + (i-1)*num_dims, f, num_dims);
+            }
+            inv_b[i] = 1.0/b;
+            b_prev = b;
+            c_prev = c;
+        }
+        std::copy(points + begin*num_dims, points + end*num_dims, out_points + begin*num_dims);
+
+        // Rows behind the sweep, reaching back one more chunk such that the
+        // partial pages kept by the previous release are dropped now
+        const std::size_t done = end - 1;
+        const std::size_t first = begin > chunk ? begin - chunk : 0;
+        input.release(first*row_size, done*row_size);
+        spill.release(first*row_size, done*row_size);
+        spill.release(inv_b_offset + first*sizeof(T), inv_b_offset + end*sizeof(T));
+        output.release(header.points_offset + first*row_size, header.points_offset + end*row_size);
+    }
+
+    // Backward substitution, segment i is expanded once M_i is known
+    auto expand = [&](const std::size_t i)
+    {
+        for(std::size_t j = 0; j < num_dims; j++)
+        {
+            Solver::power_basis(out_points[i*num_dims+j], out_points[(i+1)*num_dims+j],
+                d[i*num_dims+j], d[(i+1)*num_dims+j], &coefficients[4*(i*num_dims+j)]);
+        }
+    };
+    for(std::size_t end = n; end > 0;)
+    {
+        const std::size_t begin = end > chunk ? end - chunk : 0;
+        for(std::size_t i = end; i-- > begin;)
+        {
+            if(i == n - 1)
+            {
+                for(std::size_t j = 0; j < num_dims; j++) d[i*num_dims+j] *= inv_b[i];
+                continue;
+            }
+            T a, b, c;
+            moment_row(n, left_bc, right_bc, i, a, b, c);
+            SweepKernel<T>::substitute(d + i*num_dims, d + (i+1)*num_dims, c, inv_b[i], num_dims);
+            expand(i);
+        }
+
+        // Rows behind the sweep, likewise reaching one chunk further
+        const std::size_t first = begin + 1;
+        const std::size_t last = std::min(n, end + chunk);
+        spill.release(first*row_size, last*row_size);
+        spill.release(inv_b_offset + begin*sizeof(T), inv_b_offset + last*sizeof(T));
+        output.release(header.points_offset + first*row_size, header.points_offset + last*row_size);
+        output.release(header.coefficients_offset + 4*begin*row_size,
+            header.coefficients_offset + 4*std::min(n - 1, last)*row_size);
+        end = begin;
+    }
+
+    // Not-a-knot end moments, only the end segments change
+    const bool left_not_a_knot = n > 2 && left_bc == BoundaryCondition::NotAKnot;
+    const bool right_not_a_knot = n > 2 && right_bc == BoundaryCondition::NotAKnot;
+    if(left_not_a_knot || right_not_a_knot)
+    {
+        extrapolate_not_a_knot(left_not_a_knot, right_not_a_knot, n, num_dims, num_dims, d);
+        expand(0);
+        expand(n - 2);
+    }
+
+    if(!output.sync()) return false;
+    std::memcpy(output.data(), &header, sizeof(header));
+    return output.sync();
+#else
+    (void)input_path;
+    (void)output_path;
+    (void)left_bc;
+    (void)right_bc;
+    (void)left_tangent;
+    (void)right_tangent;
+    return false;
+#endif
+}
+
+} // namespace: parametric_cubic_spline
@@ -0,0 +1,193 @@
+/*
+ * MIT License
+ *
+ * Parametric Cubic Spline Library
+ * Copyright (c) 2021-, Michael Heidingsfeld
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#pragma once
+
+#include <thread>
+#include <utility>
+
+#include "parametric_cubic_spline/impl/thread_pool.hpp"
+
+namespace parametric_cubic_spline {
+
+template<typename T, std::size_t NumPoints, std::size_t NumDims, typename Layout, std::size_t NumVersions>
+SplineHandle<T, NumPoints, NumDims, Layout, NumVersions>::ReadGuard::~ReadGuard()
+{
+    if(version_) version_->num_readers.fetch_sub(1, std::memory_order_release);
+}
+
+template<typename T, std::size_t NumPoints, std::size_t NumDims, typename Layout, std::size_t NumVersions>
+SplineHandle<T, NumPoints, NumDims, Layout, NumVersions>::SplineHandle() :
+    current_(0),
+    num_requests_(0),
+    published_request_(0),
+    num_pending_(0)
+{
+    static_assert(NumVersions > 1, "'NumVersions' must be greater than one.");
+    for(Version &version : versions_)
+    {
+        version.num_readers.store(0);
+        version.spline.enable_coefficient_cache();
+        version.spline.enable_factorization_cache();
+    }
+}
+
+template<typename T, std::size_t NumPoints, std::size_t NumDims, typename Layout, std::size_t NumVersions>
+SplineHandle<T, NumPoints, NumDims, Layout, NumVersions>::~SplineHandle()
+{
+    // queued jobs refer to this handle
+    std::unique_lock<std::mutex> lock(pending_mutex_);
+    pending_done_.wait(lock, [this]() { return num_pending_ == 0; });
+}
+
+template<typename T, std::size_t NumPoints, std::size_t NumDims, typename Layout, std::size_t NumVersions>
+void SplineHandle<T, NumPoints, NumDims, Layout, NumVersions>::set(
+    const T *points,
+    const std::size_t num_points,
+    const std::size_t num_dims,
+    const BoundaryCondition left_bc,
+    const BoundaryCondition right_bc,
+    const T *left_tangent,
+    const T *right_tangent
+)
+{
+    update(++num_requests_, points, num_points, num_dims, left_bc, right_bc, left_tangent, right_tangent);
+}
+
+template<typename T, std::size_t NumPoints, std::size_t NumDims, typename Layout, std::size_t NumVersions>
+std::future<void> SplineHandle<T, NumPoints, NumDims, Layout, NumVersions>::async_set(
+    const T *points,
+    const std::size_t num_points,
+    const std::size_t num_dims,
+    const BoundaryCondition left_bc,
+    const BoundaryCondition right_bc,
+    const T *left_tangent,
+    const T *right_tangent
+)
+{
+    // the caller may reuse its buffers as soon as this returns
+    std::vector<T> input(points, points + num_points*num_dims);
+    std::vector<T> tangents;
+    if(left_tangent) tangents.insert(tangents.end(), left_tangent, left_tangent + num_dims);
+    if(right_tangent) tangents.insert(tangents.end(), right_tangent, right_tangent + num_dims);
+    const bool has_left = left_tangent != nullptr;
+    const bool has_right = right_tangent != nullptr;
+
+    const std::uint64_t request = ++num_requests_;
+    {
+        std::lock_guard<std::mutex> lock(pending_mutex_);
+        num_pending_++;
+    }
+    return internal::ThreadPool::instance().submit(
+        [this, request, input = std::move(input), tangents = std::move(tangents),
+         num_points, num_dims, left_bc, right_bc, has_left, has_right]()
+        {
+            // Notified under the lock, the handle may be destroyed as soon as
+            // it is released, also if the update throws
+            struct Done
+            {
+                SplineHandle *handle;
+                ~Done()
+                {
+                    std::lock_guard<std::mutex> lock(handle->pending_mutex_);
+                    handle->num_pending_--;
+                    handle->pending_done_.notify_all();
+                }
+            } done{this};
+
+            const T *left = has_left ? tangents.data() : nullptr;
+            const T *right = has_right ? tangents.data() + (has_left ? num_dims : 0) : nullptr;
+            update(request, input.data(), num_points, num_dims, left_bc, right_bc, left, right);
+        });
+}
+
+template<typename T, std::size_t NumPoints, std::size_t NumDims, typename Layout, std::size_t NumVersions>
+void SplineHandle<T, NumPoints, NumDims, Layout, NumVersions>::update(
+    const std::uint64_t request,
+    const T *points,
+    const std::size_t num_points,
+    const std::size_t num_dims,
+    const BoundaryCondition left_bc,
+    const BoundaryCondition right_bc,
+    const T *left_tangent,
+    const T *right_tangent
+)
+{
+    std::lock_guard<std::mutex> lock(writer_mutex_);
+    if(request < published_request_) return;
+
+    // Any version except the published one without readers. A reader that
+    // pins a version checks afterwards that it is still published, hence it
+    // backs off from the version taken here before reading it.
+    const std::size_t current = current_.load();
+    std::size_t next = current;
+    while(next == current)
+    {
+        for(std::size_t k = 1; k < NumVersions; k++)
+        {
+            const std::size_t i = (current + k) % NumVersions;
+            if(versions_[i].num_readers.load() == 0)
+            {
+                next = i;
+                break;
+            }
+        }
+        if(next == current) std::this_thread::yield();
+    }
+
+    Version &version = versions_[next];
+    version.points.assign(points, points + num_points*num_dims);
+    version.spline.set(version.points.data(), num_points, num_dims, left_bc, right_bc, left_tangent, right_tangent);
+    current_.store(next);
+    published_request_ = request;
+}
+
+template<typename T, std::size_t NumPoints, std::size_t NumDims, typename Layout, std::size_t NumVersions>
+void SplineHandle<T, NumPoints, NumDims, Layout, NumVersions>::reserve(
+    const std::size_t num_points,
+    const std::size_t num_dims
+)
+{
+    for(Version &version : versions_)
+    {
+        version.points.reserve(num_points*num_dims);
+        version.spline.reserve(num_points, num_dims);
+    }
+}
+
+template<typename T, std::size_t NumPoints, std::size_t NumDims, typename Layout, std::size_t NumVersions>
+typename SplineHandle<T, NumPoints, NumDims, Layout, NumVersions>::ReadGuard
+SplineHandle<T, NumPoints, NumDims, Layout, NumVersions>::read() const
+{
+    for(;;)
+    {
+        const std::size_t i = current_.load();
+        versions_[i].num_readers.fetch_add(1);
+        if(current_.load() == i) return ReadGuard(&versions_[i]);
+        // published concurrently, the writer may already rebuild version i
+        versions_[i].num_readers.fetch_sub(1);
+    }
+}
+
+} // namespace: parametric_cubic_spline
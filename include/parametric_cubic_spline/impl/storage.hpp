@@ -0,0 +1,79 @@
+/*
+ * MIT License
+ *
+ * Parametric Cubic Spline Library
+ * Copyright (c) 2021-, Michael Heidingsfeld
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <vector>
+
+namespace parametric_cubic_spline {
+
+namespace internal {
+
+    /**
+     * Statically allocated array
+     */
+    template<typename T, std::size_t N>
+    class StorageType
+    {
+        std::array<T, N> data_;
+    public:
+        StorageType() = default;
+        StorageType(std::size_t) { /* Do nothing */ }
+        inline void resize(std::size_t) { /* Do nothing */ }
+        inline void reserve(std::size_t) { /* Do nothing */ }
+        inline void swap(StorageType &other) { data_.swap(other.data_); }
+        inline T* data() { return data_.data(); }
+        inline const T* data() const { return data_.data(); }
+        inline T& operator[](int pos) { return data_[pos]; }
+        inline const T& operator[](int pos) const { return data_[pos]; }
+    };
+
+    /**
+     * Partial template specialization for dynamically allocated array
+     *
+     * Resizing keeps the allocated capacity, hence shrinking or growing up to
+     * a previously reserved size does not allocate. Contents are unspecified
+     * after resizing.
+     */
+    template<typename T>
+    class StorageType<T, Dynamic>
+    {
+        std::vector<T> data_;
+    public:
+        StorageType() = default;
+        StorageType(std::size_t size) { resize(size); }
+        inline void resize(std::size_t size) { data_.resize(size); }
+        inline void reserve(std::size_t size) { data_.reserve(size); }
+        inline void swap(StorageType &other) { data_.swap(other.data_); }
+        inline T* data() { return data_.data(); }
+        inline const T* data() const { return data_.data(); }
+        inline T& operator[](int pos) { return data_[pos]; }
+        inline const T& operator[](int pos) const { return data_[pos]; }
+    };
+
+} // namespace: internal
+
+} // namespace: parametric_cubic_spline
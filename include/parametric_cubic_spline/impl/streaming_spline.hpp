@@ -0,0 +1,232 @@
+/*
+ * MIT License
+ *
+ * Parametric Cubic Spline Library
+ * Copyright (c) 2021-, Michael Heidingsfeld
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <type_traits>
+
+namespace parametric_cubic_spline {
+
+template<typename T>
+StreamingSpline<T>::StreamingSpline(
+    const std::size_t num_dims,
+    const std::size_t capacity,
+    const std::size_t tail
+) :
+    num_dims_(num_dims),
+    capacity_(capacity),
+    tail_(tail),
+    num_points_(0),
+    start_(0),
+    is_coupled_(false)
+{
+    static_assert(std::is_floating_point<T>::value, "T must be a floating point type.");
+
+    // Rows until the influence of the end is below machine precision
+    if(tail_ == 0)
+    {
+        tail_ = static_cast<std::size_t>(std::ceil(
+            std::log(std::numeric_limits<T>::epsilon())/std::log(2.0 - std::sqrt(3.0)))) + 1;
+    }
+
+    // Preallocate everything, append() does not allocate
+    const std::size_t rows = std::min(capacity_, tail_);
+    points_.resize(capacity_*num_dims_);
+    moments_.resize(capacity_*num_dims_);
+    factorization_.reserve(rows);
+    workspace_.resize(3*rows + rows*num_dims_);
+}
+
+template<typename T>
+void StreamingSpline<T>::append(const T *point)
+{
+    if(num_points_ == capacity_)
+    {
+        // Drop the oldest point, its moment is final
+        start_ = index(1);
+        num_points_--;
+    }
+    std::copy(point, point + num_dims_, &points_[index(num_points_)*num_dims_]);
+    num_points_++;
+    solve_tail();
+}
+
+template<typename T>
+void StreamingSpline<T>::clear()
+{
+    num_points_ = 0;
+    start_ = 0;
+}
+
+template<typename T>
+void StreamingSpline<T>::solve_tail()
+{
+    // Rows [first, n) are solved with M_first-1 moved to the right-hand
+    // side, or with a natural start if the window is no longer than the tail
+    const std::size_t n = num_points_;
+    const std::size_t num_dims = num_dims_;
+    const std::size_t first = n > tail_ ? n - tail_ : 0;
+    const std::size_t m = n - first;
+    const bool coupled = first > 0;
+
+    // Workspace: the three diagonals followed by the right-hand side
+    T *lower = workspace_.data();
+    T *diag = lower + m;
+    T *upper = diag + m;
+    T *d = upper + m;
+
+    // The matrix only changes while the window fills up
+    if(!factorization_.matches(m, BoundaryCondition::Natural, BoundaryCondition::Natural)
+        || is_coupled_ != coupled)
+    {
+        for(std::size_t r = 0; r < m; r++)
+        {
+            lower[r] = 1.0;
+            diag[r] = 4.0;
+            upper[r] = 1.0;
+        }
+        lower[0] = 0.0;
+        if(!coupled)
+        {
+            diag[0] = 1.0;
+            upper[0] = 0.0;
+        }
+        lower[m-1] = 0.0;
+        diag[m-1] = 1.0;
+        upper[m-1] = 0.0;
+        factorization_.compute(m, BoundaryCondition::Natural, BoundaryCondition::Natural,
+            lower, diag, upper);
+        is_coupled_ = coupled;
+    }
+
+    for(std::size_t r = 0; r < m; r++)
+    {
+        const std::size_t k = first + r;
+        for(std::size_t j = 0; j < num_dims; j++)
+        {
+            if(k == 0 || k + 1 == n)
+            {
+                // natural ends
+                d[r*num_dims+j] = 0.0;
+                continue;
+            }
+            const T p0 = points_[index(k-1)*num_dims+j];
+            const T p1 = points_[index(k)*num_dims+j];
+            const T p2 = points_[index(k+1)*num_dims+j];
+            d[r*num_dims+j] = 6.0*((p2 - p1) - (p1 - p0));
+        }
+    }
+    if(coupled)
+    {
+        for(std::size_t j = 0; j < num_dims; j++)
+        {
+            d[j] -= moments_[index(first-1)*num_dims+j];
+        }
+    }
+
+    Spline<T, Dynamic, Dynamic>::tdma(m, num_dims, num_dims, factorization_, d);
+
+    for(std::size_t r = 0; r < m; r++)
+    {
+        std::copy(d + r*num_dims, d + (r+1)*num_dims, &moments_[index(first+r)*num_dims]);
+    }
+}
+
+template<typename T>
+std::size_t StreamingSpline<T>::index(const std::size_t i) const
+{
+    // Slot of the i-th point of the window in the ring buffer
+    const std::size_t k = start_ + i;
+    return k < capacity_ ? k : k - capacity_;
+}
+
+template<typename T>
+void StreamingSpline<T>::eval(
+    const T pos,
+    T *out_point
+) const
+{
+    // Positions outside of [0, 1] are extrapolated from the first or last
+    // segment
+    const std::size_t num_segments = num_points_ - 1;
+    const T s = pos*num_segments;
+    std::size_t i = s > 0 ? static_cast<std::size_t>(s) : 0;
+    if(i > num_segments - 1) i = num_segments - 1;
+    const T t = s - i;
+
+    const T t0 = t*t*t;
+    const T t1 = (1-t)*(1-t)*(1-t);
+    const T *p0 = &points_[index(i)*num_dims_];
+    const T *p1 = &points_[index(i+1)*num_dims_];
+    const T *m0 = &moments_[index(i)*num_dims_];
+    const T *m1 = &moments_[index(i+1)*num_dims_];
+    for(std::size_t j = 0; j < num_dims_; j++)
+    {
+        const T c = (p1[j] - p0[j]) - 1.0/6.0*(m1[j] - m0[j]);
+        const T d = p0[j] - 1.0/6.0*m0[j];
+        *out_point++ = 1.0/6.0*(t1*m0[j] + t0*m1[j]) + c*t + d;
+    }
+}
+
+template<typename T>
+void StreamingSpline<T>::eval(
+    const T *pos,
+    const std::size_t num_pos,
+    T *out_points
+) const
+{
+    for(std::size_t k = 0; k < num_pos; k++)
+    {
+        eval(pos[k], &out_points[k*num_dims_]);
+    }
+}
+
+template<typename T>
+std::size_t StreamingSpline<T>::num_points() const
+{
+    return num_points_;
+}
+
+template<typename T>
+std::size_t StreamingSpline<T>::num_dims() const
+{
+    return num_dims_;
+}
+
+template<typename T>
+std::size_t StreamingSpline<T>::capacity() const
+{
+    return capacity_;
+}
+
+template<typename T>
+std::size_t StreamingSpline<T>::tail() const
+{
+    return tail_;
+}
+
+} // namespace: parametric_cubic_spline
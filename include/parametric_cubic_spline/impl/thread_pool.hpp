@@ -0,0 +1,182 @@
+/*
+ * MIT License
+ *
+ * Parametric Cubic Spline Library
+ * Copyright (c) 2021-, Michael Heidingsfeld
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace parametric_cubic_spline {
+
+namespace internal {
+
+    /**
+     * Process-wide worker pool
+     *
+     * Workers are started lazily up to the largest number of threads
+     * requested so far. In parallel_for() the calling thread takes part in
+     * the work and only waits for tasks already claimed by other threads,
+     * hence nested use from within a task cannot deadlock. submit() runs a
+     * single job in the background.
+     */
+    class ThreadPool
+    {
+        std::mutex mutex_;
+        std::condition_variable condition_;
+        std::deque<std::function<void()>> jobs_;
+        std::vector<std::thread> workers_;
+        bool stop_;
+
+        ThreadPool() : stop_(false) {}
+
+        void work()
+        {
+            for(;;)
+            {
+                std::function<void()> job;
+                {
+                    std::unique_lock<std::mutex> lock(mutex_);
+                    condition_.wait(lock, [this]() { return stop_ || !jobs_.empty(); });
+                    if(stop_ && jobs_.empty()) return;
+                    job = std::move(jobs_.front());
+                    jobs_.pop_front();
+                }
+                job();
+            }
+        }
+
+        void reserve(const std::size_t num_workers)
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            while(workers_.size() < num_workers)
+            {
+                workers_.emplace_back(&ThreadPool::work, this);
+            }
+        }
+
+        void push(std::function<void()> job)
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                jobs_.push_back(std::move(job));
+            }
+            condition_.notify_one();
+        }
+
+    public:
+        ~ThreadPool()
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                stop_ = true;
+            }
+            condition_.notify_all();
+            for(auto &worker : workers_) worker.join();
+        }
+
+        static ThreadPool& instance()
+        {
+            static ThreadPool pool;
+            return pool;
+        }
+
+        // number of threads used for num_threads = 0
+        static std::size_t default_num_threads()
+        {
+            return std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+        }
+
+        // run fn(k) for k = 0 ... num_tasks-1 on up to num_threads threads
+        template<typename F>
+        void parallel_for(
+            const std::size_t num_tasks,
+            std::size_t num_threads,
+            const F &fn
+        )
+        {
+            if(num_threads == 0) num_threads = default_num_threads();
+            num_threads = std::min(num_threads, num_tasks);
+            if(num_threads <= 1)
+            {
+                for(std::size_t k = 0; k < num_tasks; k++) fn(k);
+                return;
+            }
+
+            struct State
+            {
+                std::atomic<std::size_t> next;
+                std::atomic<std::size_t> done;
+                std::mutex mutex;
+                std::condition_variable condition;
+            };
+            auto state = std::make_shared<State>();
+            state->next = 0;
+            state->done = 0;
+            const F *task = &fn;
+            auto run = [state, task, num_tasks]() {
+                std::size_t k;
+                while((k = state->next++) < num_tasks)
+                {
+                    (*task)(k);
+                    if(++state->done == num_tasks)
+                    {
+                        std::lock_guard<std::mutex> lock(state->mutex);
+                        state->condition.notify_all();
+                    }
+                }
+            };
+
+            reserve(num_threads - 1);
+            for(std::size_t i = 0; i < num_threads - 1; i++) push(run);
+            run();
+
+            std::unique_lock<std::mutex> lock(state->mutex);
+            state->condition.wait(lock, [&]() { return state->done == num_tasks; });
+        }
+
+        // run fn() on a worker, the future holds its result
+        template<typename F>
+        std::future<decltype(std::declval<F&>()())> submit(F fn)
+        {
+            typedef decltype(std::declval<F&>()()) Result;
+            auto task = std::make_shared<std::packaged_task<Result()>>(std::move(fn));
+            std::future<Result> result = task->get_future();
+            reserve(1);
+            push([task]() { (*task)(); });
+            return result;
+        }
+    };
+
+} // namespace: internal
+
+} // namespace: parametric_cubic_spline
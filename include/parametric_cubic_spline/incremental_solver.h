@@ -0,0 +1,119 @@
+/*
+ * MIT License
+ *
+ * Parametric Cubic Spline Library
+ * Copyright (c) 2021-, Michael Heidingsfeld
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "parametric_cubic_spline/parametric_cubic_spline.h"
+
+namespace parametric_cubic_spline {
+
+/**
+ * Resumable set() with bounded work per call
+ *
+ * begin() prepares solving a spline for new points, step() then performs at
+ * most a given number of row operations of assembly, forward elimination,
+ * back substitution, periodic correction and coefficient expansion each.
+ * Moments and coefficients are built in buffers of the solver and swapped
+ * into the spline by the step that completes, until then the spline keeps
+ * evaluating its previous data. The factorization is computed in begin()
+ * unless the spline uses the factorization cache and it is cached already.
+ * Points must stay valid as for set(), the spline must not be set otherwise
+ * while solving.
+ */
+template<
+    typename T,
+    std::size_t NumPoints = Dynamic,
+    std::size_t NumDims = Dynamic,
+    typename Layout = layout::AoS
+>
+class IncrementalSolver
+{
+public:
+    typedef Spline<T, NumPoints, NumDims, Layout> SplineType;
+
+private:
+    static constexpr std::size_t NumPaddedDims = internal::LayoutTraits<Layout>::padded_dims(NumDims);
+
+    enum class Phase
+    {
+        Idle,
+        Assemble,
+        Eliminate,
+        Substitute,
+        Correct,
+        Coefficients
+    };
+
+    SplineType *spline_;
+    const T *points_;
+    std::size_t num_points_;
+    std::size_t num_dims_;
+    BoundaryCondition left_bc_;
+    BoundaryCondition right_bc_;
+    std::vector<T> tangents_;
+    const T *left_tangent_;
+    const T *right_tangent_;
+    internal::Factorization<T, NumPoints> factorization_;
+    std::shared_ptr<const internal::Factorization<T, NumPoints>> shared_factorization_;
+    const internal::Factorization<T, NumPoints> *active_factorization_;
+    internal::StorageType<T, NumPoints*NumPaddedDims> moments_;
+    internal::StorageType<T, Dynamic> coefficients_;
+    bool use_coefficients_;
+    Phase phase_;
+    std::size_t row_;
+
+    void process_row();
+    void finish_phase();
+    void publish();
+
+public:
+    IncrementalSolver();
+
+    // start solving spline for new points, replaces a solve in progress
+    void begin(
+        SplineType &spline,
+        const T *points,
+        const std::size_t num_points,
+        const std::size_t num_dims = NumDims,
+        const BoundaryCondition left_bc = BoundaryCondition::Natural,
+        const BoundaryCondition right_bc = BoundaryCondition::Natural,
+        const T *left_tangent = nullptr,
+        const T *right_tangent = nullptr
+    );
+
+    // perform up to max_rows row operations, returns true once the spline
+    // holds the new solution
+    bool step(const std::size_t max_rows);
+
+    // true between begin() and the completing step()
+    bool is_running() const;
+};
+
+} // namespace: parametric_cubic_spline
+
+#include "parametric_cubic_spline/impl/incremental_solver.hpp"
@@ -0,0 +1,106 @@
+/*
+ * MIT License
+ *
+ * Parametric Cubic Spline Library
+ * Copyright (c) 2021-, Michael Heidingsfeld
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#pragma once
+
+#include <cstddef>
+#include <unordered_map>
+#include <vector>
+
+#include "parametric_cubic_spline/parametric_cubic_spline.h"
+
+namespace parametric_cubic_spline {
+
+/**
+ * Natural uniform spline with moments computed on demand
+ *
+ * The inner rows of the natural system form the Toeplitz matrix
+ * tridiag(1, 4, 1), whose inverse is known in closed form and decays by
+ * 2 - sqrt(3) per row away from the diagonal. set() only stores the points,
+ * and the moments of a segment are summed from the second differences of a
+ * window of neighboring points when the segment is first evaluated, to
+ * machine precision. Segments are memoized as power-basis coefficients,
+ * hence eval() is not const and must not be called concurrently. Splines
+ * of up to 2*window() + 1 points are solved as a whole on set().
+ */
+template<typename T>
+class LazySpline
+{
+    std::size_t num_points_;
+    std::size_t num_dims_;
+    const T *points_;
+    std::size_t window_;
+    std::vector<T> inverse_;
+    std::vector<T> moments_;
+    internal::Factorization<T, Dynamic> factorization_;
+    std::unordered_map<std::size_t, std::size_t> segments_;
+    std::vector<T> coefficients_;
+
+public:
+    LazySpline();
+
+    // points are referenced, not copied
+    void set(
+        const T *points,
+        const std::size_t num_points,
+        const std::size_t num_dims
+    );
+
+    // single point, computes the segment on first use
+    void eval(
+        const T pos,
+        T *out_point
+    );
+
+    // variable lengths
+    void eval(
+        const T *pos,
+        const std::size_t num_pos,
+        T *out_points
+    );
+
+    // number of points of the current spline
+    std::size_t num_points() const;
+
+    // number of dimensions of the current spline
+    std::size_t num_dims() const;
+
+    // number of segments computed since set()
+    std::size_t num_computed_segments() const;
+
+    // neighbors on either side summed per moment
+    std::size_t window() const;
+
+private:
+    const T* segment(const std::size_t i);
+
+    void moment(
+        const std::size_t k,
+        T *m
+    ) const;
+};
+
+} // namespace: parametric_cubic_spline
+
+#include "parametric_cubic_spline/impl/lazy_spline.hpp"
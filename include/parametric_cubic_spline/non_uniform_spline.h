@@ -0,0 +1,139 @@
+/*
+ * MIT License
+ *
+ * Parametric Cubic Spline Library
+ * Copyright (c) 2021-, Michael Heidingsfeld
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "parametric_cubic_spline/parametric_cubic_spline.h"
+
+namespace parametric_cubic_spline {
+
+/**
+ * Choice of knots for a non-uniform spline
+ */
+enum class Parameterization
+{
+    Uniform,        // equally spaced
+    ChordLength,    // spacing proportional to the distance of the points
+    Centripetal     // spacing proportional to the square root of the distance
+};
+
+/**
+ * Spline with non-uniform knots
+ *
+ * Knots are normalized to [0, 1] and the moments are solved from the
+ * non-uniform tridiagonal system with the same factorization and sweeps as
+ * Spline. Only the power-basis coefficients per segment are kept, the
+ * points are not referenced after set(). Segments are found through a
+ * guide table of equally spaced cells, each holding the first segment it
+ * overlaps, followed by a binary search among the few segments of the cell.
+ * Tangents of Hermite boundaries are derivatives with respect to pos.
+ * Knots from chord length or centripetal spacing merge coincident
+ * consecutive points, num_points() then counts the distinct ones.
+ */
+template<typename T>
+class NonUniformSpline
+{
+    std::size_t num_points_;
+    std::size_t num_dims_;
+    std::vector<T> knots_;
+    std::vector<T> coefficients_;
+    std::vector<std::size_t> guide_;
+    std::vector<T> merged_;
+    internal::Factorization<T, Dynamic> factorization_;
+    std::vector<T> workspace_;
+
+public:
+    NonUniformSpline();
+
+    // knots from the points, at least two of them distinct
+    void set(
+        const T *points,
+        const std::size_t num_points,
+        const std::size_t num_dims,
+        const Parameterization parameterization,
+        const BoundaryCondition left_bc = BoundaryCondition::Natural,
+        const BoundaryCondition right_bc = BoundaryCondition::Natural,
+        const T *left_tangent = nullptr,
+        const T *right_tangent = nullptr
+    );
+
+    // strictly increasing knots, one more for periodic boundaries, which is
+    // the knot of the first point closing the curve
+    void set(
+        const T *points,
+        const std::size_t num_points,
+        const std::size_t num_dims,
+        const T *knots,
+        const BoundaryCondition left_bc = BoundaryCondition::Natural,
+        const BoundaryCondition right_bc = BoundaryCondition::Natural,
+        const T *left_tangent = nullptr,
+        const T *right_tangent = nullptr
+    );
+
+    // single point
+    void eval(
+        const T pos,
+        T *out_point
+    ) const;
+
+    // variable lengths
+    void eval(
+        const T *pos,
+        const std::size_t num_pos,
+        T *out_points
+    ) const;
+
+    // number of points of the current spline
+    std::size_t num_points() const;
+
+    // number of dimensions of the current spline
+    std::size_t num_dims() const;
+
+    // normalized knots, knots()[0] = 0 and knots()[num_points()-1] = 1
+    const T *knots() const;
+
+private:
+    std::size_t locate(
+        const T pos,
+        T &t
+    ) const;
+
+    void solve(
+        const T *points,
+        const BoundaryCondition left_bc,
+        const BoundaryCondition right_bc,
+        const T *left_tangent,
+        const T *right_tangent,
+        const T closing_interval
+    );
+
+    void build_guide();
+};
+
+} // namespace: parametric_cubic_spline
+
+#include "parametric_cubic_spline/impl/non_uniform_spline.hpp"
@@ -24,6 +24,9 @@
  */
 #pragma once
 
+#include <cstddef>
+#include <memory>
+
 namespace parametric_cubic_spline {
 
 namespace internal {
@@ -31,8 +34,29 @@ namespace internal {
     template<typename T, std::size_t N>
     class StorageType;
 
+    template<typename T, std::size_t N>
+    class Factorization;
+
 } // namespace: internal
 
+template<typename T>
+class SplineBank;
+
+template<typename T, std::size_t NumPoints, std::size_t NumDims, typename Layout>
+class IncrementalSolver;
+
+template<typename T>
+class NonUniformSpline;
+
+template<typename T>
+class StreamingSpline;
+
+template<typename T>
+class LazySpline;
+
+template<typename T>
+class SplineFileBuilder;
+
 /**
  * Constant used to express dynamic size
  */
@@ -49,22 +73,84 @@ enum class BoundaryCondition
     NotAKnot
 };
 
+/**
+ * Storage layouts of moments and coefficients
+ */
+namespace layout {
+
+    // dimensions of a point stored contiguously
+    struct AoS {};
+
+    // one contiguous array per dimension
+    struct SoA {};
+
+    // dimensions grouped into blocks of Width, each stored point by point
+    template<std::size_t Width>
+    struct AoSoA {};
+
+} // namespace: layout
+
+} // namespace: parametric_cubic_spline
+
+#include "parametric_cubic_spline/impl/layout.hpp"
+
+namespace parametric_cubic_spline {
+
 /**
  * Spline class
  */
 template<
     typename T,
     std::size_t NumPoints = Dynamic,
-    std::size_t NumDims = Dynamic
+    std::size_t NumDims = Dynamic,
+    typename Layout = layout::AoS
 >
 class Spline
 {
+    template<typename> friend class SplineBank;
+    template<typename, std::size_t, std::size_t, typename> friend class IncrementalSolver;
+    template<typename> friend class NonUniformSpline;
+    template<typename> friend class StreamingSpline;
+    template<typename> friend class LazySpline;
+    template<typename> friend class SplineFileBuilder;
+
+    static constexpr std::size_t NumPaddedDims = internal::LayoutTraits<Layout>::padded_dims(NumDims);
+
     std::size_t num_points_;
     std::size_t num_dims_;
     const T *points_;
-    internal::StorageType<T, NumPoints*NumDims> moments_;
+    BoundaryCondition left_bc_;
+    BoundaryCondition right_bc_;
+    internal::StorageType<T, NumPoints*NumPaddedDims> moments_;
+    bool use_coefficient_cache_;
+    internal::StorageType<T, Dynamic> coefficients_;
+    bool use_factorization_cache_;
+    internal::Factorization<T, NumPoints> factorization_;
+    std::shared_ptr<const internal::Factorization<T, NumPoints>> shared_factorization_;
+    std::size_t version_;
+    std::size_t num_threads_;
+    internal::StorageType<T, Dynamic> partition_workspace_;
 
 public:
+    /**
+     * Evaluation state for temporally coherent queries
+     *
+     * Keeps the coefficients of the last evaluated segment and only reloads
+     * them when a query leaves that segment. A cursor may be reused across
+     * calls and is invalidated automatically by set().
+     */
+    class Cursor
+    {
+        friend class Spline;
+        const Spline *spline_;
+        std::size_t version_;
+        std::size_t segment_;
+        const T *coefficients_;
+        internal::StorageType<T, 4*NumDims> buffer_;
+    public:
+        Cursor() : spline_(nullptr), version_(0), segment_(0), coefficients_(nullptr) {}
+    };
+
     Spline();
 
     // variable points, variable dims, optional bc
@@ -97,20 +183,187 @@ public:
         const T *right_tangent = nullptr
     );
 
-    // variable lengths
+    // equally sized splines with equal bc, solved side by side, the tangent
+    // arrays hold one tangent per spline and may be null
+    static void set_batch(
+        Spline *splines,
+        const T *const *points,
+        const std::size_t num_splines,
+        const std::size_t num_points,
+        const std::size_t num_dims,
+        const BoundaryCondition left_bc = BoundaryCondition::Natural,
+        const BoundaryCondition right_bc = BoundaryCondition::Natural,
+        const T *const *left_tangents = nullptr,
+        const T *const *right_tangents = nullptr
+    );
+
+    // point i of the points passed to set() was changed in place, old_point
+    // holds its previous value, updates moments and coefficients locally
+    void update_point(
+        const std::size_t i,
+        const T *old_point
+    );
+
+    // variable lengths, on the threads set by set_num_threads()
     void eval(
         const T *pos,
         const std::size_t num_pos,
         T *out_points
-    );
+    ) const;
+
+    // variable lengths, split across num_threads, 0 for all cores
+    void eval_parallel(
+        const T *pos,
+        const std::size_t num_pos,
+        T *out_points,
+        const std::size_t num_threads = 0
+    ) const;
 
     // single point
     void eval(
         const T pos,
         T *out_point
+    ) const;
+
+    // variable lengths, position and derivatives w.r.t. pos, outputs may be null
+    void eval(
+        const T *pos,
+        const std::size_t num_pos,
+        T *out_points,
+        T *out_first,
+        T *out_second,
+        T *out_third = nullptr
+    ) const;
+
+    // number of points of the current spline
+    std::size_t num_points() const;
+
+    // number of dimensions of the current spline
+    std::size_t num_dims() const;
+
+    // preallocate storage such that set() does not allocate up to this size
+    void reserve(
+        const std::size_t num_points,
+        const std::size_t num_dims = NumDims
     );
 
+    // equally spaced positions k/(num_samples-1), k = 0 ... num_samples-1
+    void eval_uniform(
+        const std::size_t num_samples,
+        T *out_points
+    ) const;
+
+    // single point, advancing the cursor
+    void eval(
+        Cursor &cursor,
+        const T pos,
+        T *out_point
+    ) const;
+
+    // variable lengths, advancing the cursor, fastest for sorted positions
+    void eval(
+        Cursor &cursor,
+        const T *pos,
+        const std::size_t num_pos,
+        T *out_points
+    ) const;
+
+    // precompute power-basis coefficients on set() and use them in eval()
+    void enable_coefficient_cache(const bool enable = true);
+
+    // share matrix factorizations between splines of equal size and bc
+    void enable_factorization_cache(const bool enable = true);
+
+    // release all factorizations held by the shared cache
+    static void clear_factorization_cache();
+
+    // threads used by set() and batch eval(), 1 for serial, 0 for all cores
+    void set_num_threads(const std::size_t num_threads);
+
 private:
+    std::size_t moment_index(
+        const std::size_t i,
+        const std::size_t j
+    ) const;
+
+    std::size_t coefficient_index(
+        const std::size_t i,
+        const std::size_t j
+    ) const;
+
+    void locate(
+        const T pos,
+        std::size_t &i,
+        T &t
+    ) const;
+
+    void eval_cached(
+        const T pos,
+        T *out_point
+    ) const;
+
+    void eval_batch(
+        const T *pos,
+        const std::size_t num_pos,
+        T *out_points,
+        const std::size_t num_threads
+    ) const;
+
+    void eval_channels(
+        const T *pos,
+        const std::size_t num_pos,
+        const std::size_t dim_begin,
+        const std::size_t dim_end,
+        T *out_points
+    ) const;
+
+    const T* segment_coefficients(
+        const std::size_t i,
+        const std::size_t j,
+        T *buffer
+    ) const;
+
+    static void power_basis(
+        const T p0,
+        const T p1,
+        const T m0,
+        const T m1,
+        T *coeffs
+    );
+
+    void compute_coefficients();
+
+    void load_segment(
+        Cursor &cursor,
+        const std::size_t i
+    ) const;
+
+    const internal::Factorization<T, NumPoints>& factorization(
+        const BoundaryCondition left_bc,
+        const BoundaryCondition right_bc
+    );
+
+    T rhs_weight(
+        const std::size_t row,
+        const std::size_t i
+    ) const;
+
+    static void assemble_rhs(
+        const T* points,
+        const std::size_t num_points,
+        const std::size_t num_dims,
+        const BoundaryCondition left_bc,
+        const BoundaryCondition right_bc,
+        const T* left_tangent,
+        const T* right_tangent,
+        const std::size_t begin,
+        const std::size_t end,
+        const std::size_t dim_begin,
+        const std::size_t dim_end,
+        T *d,
+        const std::size_t stride
+    );
+
     static void compute_moments(
         const T* points,
         const std::size_t num_points,
@@ -119,17 +372,44 @@ private:
         const BoundaryCondition right_bc,
         const T* left_tangent,
         const T* right_tangent,
-        internal::StorageType<T, NumPoints*NumDims> &m
+        const internal::Factorization<T, NumPoints> &factorization,
+        internal::StorageType<T, NumPoints*NumPaddedDims> &m,
+        const std::size_t num_threads,
+        internal::StorageType<T, Dynamic> &workspace
+    );
+
+    static void assemble_block(
+        T *m,
+        const std::size_t num_points,
+        const std::size_t num_dims,
+        const std::size_t width,
+        const std::size_t b,
+        const std::size_t col_begin,
+        const std::size_t col_end,
+        const std::size_t begin,
+        const std::size_t end,
+        const T* points,
+        const BoundaryCondition left_bc,
+        const BoundaryCondition right_bc,
+        const T* left_tangent,
+        const T* right_tangent
     );
 
     static void tdma(
         const std::size_t num_points,
         const std::size_t num_dims,
-        internal::StorageType<T, NumPoints> &a,
-        internal::StorageType<T, NumPoints> &b,
-        internal::StorageType<T, NumPoints> &c,
-        internal::StorageType<T, NumPoints*NumDims> &d,
-        T *u = nullptr
+        const std::size_t stride,
+        const internal::Factorization<T, NumPoints> &factorization,
+        T *d
+    );
+
+    static void tdma_partitioned(
+        const std::size_t num_points,
+        const std::size_t num_dims,
+        const internal::Factorization<T, NumPoints> &factorization,
+        T *d,
+        const std::size_t num_threads,
+        internal::StorageType<T, Dynamic> &workspace
     );
 };
 
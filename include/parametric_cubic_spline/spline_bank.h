@@ -0,0 +1,109 @@
+/*
+ * MIT License
+ *
+ * Parametric Cubic Spline Library
+ * Copyright (c) 2021-, Michael Heidingsfeld
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "parametric_cubic_spline/parametric_cubic_spline.h"
+
+namespace parametric_cubic_spline {
+
+template<typename T>
+class SplineFileWriter;
+
+/**
+ * Container of many splines in one contiguous arena
+ *
+ * Splines of varying length but equal number of dimensions are solved on
+ * insertion and only their power-basis coefficients are kept, packed one
+ * after another into a single array. An offset index locates the
+ * coefficients of a spline, which makes evaluating spline k a lookup and a
+ * Horner scheme without touching caller memory.
+ */
+template<typename T>
+class SplineBank
+{
+    template<typename> friend class SplineFileWriter;
+
+    std::size_t num_dims_;
+    std::vector<T> coefficients_;
+    std::vector<std::size_t> offsets_;
+    Spline<T, Dynamic, Dynamic> solver_;
+
+public:
+    explicit SplineBank(const std::size_t num_dims);
+
+    // solve and append a spline, returns its id
+    std::size_t add(
+        const T *points,
+        const std::size_t num_points,
+        const BoundaryCondition left_bc = BoundaryCondition::Natural,
+        const BoundaryCondition right_bc = BoundaryCondition::Natural,
+        const T *left_tangent = nullptr,
+        const T *right_tangent = nullptr
+    );
+
+    // preallocate for num_splines splines with num_points points in total
+    void reserve(
+        const std::size_t num_splines,
+        const std::size_t num_points
+    );
+
+    // remove all splines, keeps the allocated memory
+    void clear();
+
+    // number of splines
+    std::size_t size() const;
+
+    // number of dimensions of all splines
+    std::size_t num_dims() const;
+
+    // number of points of spline id
+    std::size_t num_points(const std::size_t id) const;
+
+    // bytes allocated by arena and index
+    std::size_t memory_footprint() const;
+
+    // single point of spline id
+    void eval(
+        const std::size_t id,
+        const T pos,
+        T *out_point
+    ) const;
+
+    // variable lengths, query q evaluates spline ids[q] at pos[q]
+    void eval(
+        const std::size_t *ids,
+        const T *pos,
+        const std::size_t num_queries,
+        T *out_points,
+        const std::size_t num_threads = 1
+    ) const;
+};
+
+} // namespace: parametric_cubic_spline
+
+#include "parametric_cubic_spline/impl/spline_bank.hpp"
@@ -0,0 +1,163 @@
+/*
+ * MIT License
+ *
+ * Parametric Cubic Spline Library
+ * Copyright (c) 2021-, Michael Heidingsfeld
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "parametric_cubic_spline/spline_bank.h"
+
+namespace parametric_cubic_spline {
+
+namespace internal {
+
+// Leading block of a spline file, followed by the sections it points to,
+// each starting at a multiple of 64 bytes
+struct SplineFileHeader
+{
+    char magic[8];                      // "PCSPLINE"
+    std::uint32_t version;
+    std::uint32_t endian_tag;           // 0x01020304 in the byte order of the writer
+    std::uint32_t scalar_size;          // sizeof(T)
+    std::uint32_t num_dims;
+    std::uint64_t num_splines;
+    std::uint64_t num_points;           // over all splines
+    std::uint64_t offsets_offset;       // num_splines + 1 coefficient offsets (uint64)
+    std::uint64_t coefficients_offset;  // power-basis coefficients, as in SplineBank
+    std::uint64_t points_offset;        // input points, interleaved per point
+    std::uint64_t file_size;
+};
+
+} // namespace: internal
+
+/**
+ * Writes many splines to a binary spline file
+ *
+ * Splines are solved on insertion like in SplineBank, the file stores their
+ * power-basis coefficients together with the input points.
+ */
+template<typename T>
+class SplineFileWriter
+{
+    SplineBank<T> bank_;
+    std::vector<T> points_;
+
+public:
+    explicit SplineFileWriter(const std::size_t num_dims);
+
+    // solve and append a spline, returns its id
+    std::size_t add(
+        const T *points,
+        const std::size_t num_points,
+        const BoundaryCondition left_bc = BoundaryCondition::Natural,
+        const BoundaryCondition right_bc = BoundaryCondition::Natural,
+        const T *left_tangent = nullptr,
+        const T *right_tangent = nullptr
+    );
+
+    // number of splines
+    std::size_t size() const;
+
+    // write all splines to path, returns false on I/O errors
+    bool write(const std::string &path) const;
+};
+
+/**
+ * Read-only view of a binary spline file
+ *
+ * The file is memory mapped (POSIX, read into memory elsewhere) and
+ * evaluated in place: opening only validates the header and the offsets,
+ * coefficients and points are read through the mapping when first
+ * evaluated. Files are
+ * written in the byte order of the writer and rejected on a mismatch.
+ */
+template<typename T>
+class SplineFile
+{
+    const unsigned char *data_;
+    std::size_t size_;
+    void *mapping_;
+    std::vector<std::uint64_t> buffer_;
+
+    std::size_t num_dims_;
+    std::size_t num_splines_;
+    const std::uint64_t *offsets_;
+    const T *coefficients_;
+    const T *points_;
+
+    bool attach(const void *data, const std::size_t size);
+
+public:
+    SplineFile();
+    ~SplineFile();
+
+    SplineFile(const SplineFile &) = delete;
+    SplineFile &operator=(const SplineFile &) = delete;
+
+    // map the file at path, returns false if it cannot be read or is invalid
+    bool open(const std::string &path);
+
+    // view a spline file in memory, which must outlive the view and be
+    // aligned to at least alignof(std::uint64_t)
+    bool open(const void *data, const std::size_t size);
+
+    void close();
+
+    bool is_open() const;
+
+    // number of splines
+    std::size_t size() const;
+
+    // number of dimensions of all splines
+    std::size_t num_dims() const;
+
+    // number of points of spline id
+    std::size_t num_points(const std::size_t id) const;
+
+    // input points of spline id, interleaved per point
+    const T *points(const std::size_t id) const;
+
+    // single point of spline id
+    void eval(
+        const std::size_t id,
+        const T pos,
+        T *out_point
+    ) const;
+
+    // variable lengths, query q evaluates spline ids[q] at pos[q]
+    void eval(
+        const std::size_t *ids,
+        const T *pos,
+        const std::size_t num_queries,
+        T *out_points,
+        const std::size_t num_threads = 1
+    ) const;
+};
+
+} // namespace: parametric_cubic_spline
+
+#include "parametric_cubic_spline/impl/spline_file.hpp"
@@ -0,0 +1,74 @@
+/*
+ * MIT License
+ *
+ * Parametric Cubic Spline Library
+ * Copyright (c) 2021-, Michael Heidingsfeld
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+#include "parametric_cubic_spline/spline_file.h"
+
+namespace parametric_cubic_spline {
+
+/**
+ * Builds a spline file from a point file larger than memory
+ *
+ * The input is a raw file of T, interleaved per point, the output a spline
+ * file holding a single spline that SplineFile evaluates in place. Both are
+ * memory mapped together with a spill file next to the output, which is
+ * removed once built. The forward elimination streams over the input,
+ * spilling the eliminated right-hand side and the inverse pivots, the back
+ * substitution streams backwards over the spill and writes the coefficients
+ * of each segment into the output. Pages behind either sweep are released
+ * every chunk of rows, such that the resident memory stays bounded by a few
+ * chunks regardless of the number of points. Requires POSIX mmap and local
+ * files, periodic boundaries are not supported.
+ */
+template<typename T>
+class SplineFileBuilder
+{
+    std::size_t num_dims_;
+    std::size_t chunk_size_;
+
+public:
+    explicit SplineFileBuilder(const std::size_t num_dims);
+
+    // rows per chunk, each mapping keeps about one chunk resident
+    void set_chunk_size(const std::size_t num_rows);
+
+    // solve the spline through the points in input_path and write it to
+    // output_path, returns false on I/O errors or invalid input
+    bool build(
+        const std::string &input_path,
+        const std::string &output_path,
+        const BoundaryCondition left_bc = BoundaryCondition::Natural,
+        const BoundaryCondition right_bc = BoundaryCondition::Natural,
+        const T *left_tangent = nullptr,
+        const T *right_tangent = nullptr
+    ) const;
+};
+
+} // namespace: parametric_cubic_spline
+
+#include "parametric_cubic_spline/impl/spline_file_builder.hpp"
@@ -0,0 +1,160 @@
+/*
+ * MIT License
+ *
+ * Parametric Cubic Spline Library
+ * Copyright (c) 2021-, Michael Heidingsfeld
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <mutex>
+#include <vector>
+
+#include "parametric_cubic_spline/parametric_cubic_spline.h"
+
+namespace parametric_cubic_spline {
+
+/**
+ * Spline shared between one writer and real-time readers
+ *
+ * Keeps NumVersions splines, each with its own copy of the points. set()
+ * solves into a version no reader holds and publishes it with a single
+ * atomic store, readers pin the published version with an atomic counter
+ * and never block or wait for the writer. A version is reused once its last
+ * reader released it. With one reader thread holding one version at a time
+ * the writer never waits either, otherwise it yields until a version is
+ * free. Updates are serialized, async_set() solves on the worker pool and
+ * readers see the previous version until the new one is published.
+ */
+template<
+    typename T,
+    std::size_t NumPoints = Dynamic,
+    std::size_t NumDims = Dynamic,
+    typename Layout = layout::AoS,
+    std::size_t NumVersions = 3
+>
+class SplineHandle
+{
+public:
+    typedef Spline<T, NumPoints, NumDims, Layout> SplineType;
+
+private:
+    struct Version
+    {
+        std::atomic<std::size_t> num_readers;
+        char padding[64 - sizeof(std::atomic<std::size_t>)];
+        std::vector<T> points;
+        SplineType spline;
+    };
+
+    mutable Version versions_[NumVersions];
+    std::atomic<std::size_t> current_;
+    std::mutex writer_mutex_;
+    std::atomic<std::uint64_t> num_requests_;
+    std::uint64_t published_request_;
+    std::mutex pending_mutex_;
+    std::condition_variable pending_done_;
+    std::size_t num_pending_;
+
+    void update(
+        const std::uint64_t request,
+        const T *points,
+        const std::size_t num_points,
+        const std::size_t num_dims,
+        const BoundaryCondition left_bc,
+        const BoundaryCondition right_bc,
+        const T *left_tangent,
+        const T *right_tangent
+    );
+
+public:
+    /**
+     * Pinned version of the spline, released on destruction
+     */
+    class ReadGuard
+    {
+        friend class SplineHandle;
+
+        Version *version_;
+
+        explicit ReadGuard(Version *version) : version_(version) {}
+
+    public:
+        ReadGuard(ReadGuard &&other) : version_(other.version_) { other.version_ = nullptr; }
+        ReadGuard(const ReadGuard &) = delete;
+        ReadGuard &operator=(const ReadGuard &) = delete;
+        ~ReadGuard();
+
+        const SplineType &operator*() const { return version_->spline; }
+        const SplineType *operator->() const { return &version_->spline; }
+    };
+
+    // all versions use coefficient and factorization cache
+    SplineHandle();
+
+    // waits for the updates still queued by async_set()
+    ~SplineHandle();
+
+    SplineHandle(const SplineHandle &) = delete;
+    SplineHandle &operator=(const SplineHandle &) = delete;
+
+    // solve the next version off to the side and publish it
+    void set(
+        const T *points,
+        const std::size_t num_points,
+        const std::size_t num_dims = NumDims,
+        const BoundaryCondition left_bc = BoundaryCondition::Natural,
+        const BoundaryCondition right_bc = BoundaryCondition::Natural,
+        const T *left_tangent = nullptr,
+        const T *right_tangent = nullptr
+    );
+
+    // copy the input and solve and publish on the worker pool, updates
+    // requested later supersede this one if they finish first. The future
+    // may be dropped, the handle waits for the update when destroyed.
+    std::future<void> async_set(
+        const T *points,
+        const std::size_t num_points,
+        const std::size_t num_dims = NumDims,
+        const BoundaryCondition left_bc = BoundaryCondition::Natural,
+        const BoundaryCondition right_bc = BoundaryCondition::Natural,
+        const T *left_tangent = nullptr,
+        const T *right_tangent = nullptr
+    );
+
+    // preallocate all versions such that set() does not allocate up to this
+    // size, call before readers start
+    void reserve(
+        const std::size_t num_points,
+        const std::size_t num_dims = NumDims
+    );
+
+    // pin the published version, never blocks
+    ReadGuard read() const;
+};
+
+} // namespace: parametric_cubic_spline
+
+#include "parametric_cubic_spline/impl/spline_handle.hpp"
@@ -0,0 +1,109 @@
+/*
+ * MIT License
+ *
+ * Parametric Cubic Spline Library
+ * Copyright (c) 2021-, Michael Heidingsfeld
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "parametric_cubic_spline/parametric_cubic_spline.h"
+
+namespace parametric_cubic_spline {
+
+/**
+ * Natural spline over a sliding window of a point stream
+ *
+ * Points are appended to a ring buffer of fixed capacity, dropping the
+ * oldest point once it is full. Each append re-solves only the moments of
+ * the newest tail points, with the moment before them held fixed and a
+ * natural end at the newest point. The influence of the end on a moment
+ * decays by about 2 - sqrt(3) per point, hence older moments are final and
+ * differ from those of the natural spline through all points received so
+ * far by about (2 - sqrt(3))^tail relative to the moments. The default
+ * tail reaches machine precision. The newest tail segments are provisional
+ * and still change with the following points. A window no longer than the
+ * tail is solved as a whole, which gives the natural spline of the window.
+ */
+template<typename T>
+class StreamingSpline
+{
+    std::size_t num_dims_;
+    std::size_t capacity_;
+    std::size_t tail_;
+    std::size_t num_points_;
+    std::size_t start_;
+    std::vector<T> points_;
+    std::vector<T> moments_;
+    internal::Factorization<T, Dynamic> factorization_;
+    bool is_coupled_;
+    std::vector<T> workspace_;
+
+public:
+    // tail 0 for machine precision
+    StreamingSpline(
+        const std::size_t num_dims,
+        const std::size_t capacity,
+        const std::size_t tail = 0
+    );
+
+    // append a point, drops the oldest one if the window is full
+    void append(const T *point);
+
+    // drop all points
+    void clear();
+
+    // single point, pos in [0, 1] over the current window
+    void eval(
+        const T pos,
+        T *out_point
+    ) const;
+
+    // variable lengths
+    void eval(
+        const T *pos,
+        const std::size_t num_pos,
+        T *out_points
+    ) const;
+
+    // number of points in the window
+    std::size_t num_points() const;
+
+    // number of dimensions
+    std::size_t num_dims() const;
+
+    // maximum number of points in the window
+    std::size_t capacity() const;
+
+    // number of moments re-solved per append
+    std::size_t tail() const;
+
+private:
+    std::size_t index(const std::size_t i) const;
+
+    void solve_tail();
+};
+
+} // namespace: parametric_cubic_spline
+
+#include "parametric_cubic_spline/impl/streaming_spline.hpp"
@@ -0,0 +1,153 @@
+/*
+ * MIT License
+ *
+ * Parametric Cubic Spline Library
+ * Copyright (c) 2021-, Michael Heidingsfeld
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "parametric_cubic_spline/parametric_cubic_spline.h"
+
+using namespace parametric_cubic_spline;
+
+// Counting replacement of the global allocation functions. GCC flags free()
+// on memory from a replaced operator new, which is well-defined here.
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+static std::atomic<bool> count_allocations(false);
+static std::atomic<std::size_t> num_allocations(0);
+
+void* operator new(std::size_t size)
+{
+    if(count_allocations) num_allocations++;
+    void *ptr = std::malloc(size ? size : 1);
+    if(!ptr) throw std::bad_alloc();
+    return ptr;
+}
+
+void operator delete(void *ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+class AllocationCounter
+{
+public:
+    AllocationCounter() { num_allocations = 0; count_allocations = true; }
+    ~AllocationCounter() { count_allocations = false; }
+    std::size_t count() const { return num_allocations; }
+};
+
+static std::vector<double> make_points(std::size_t num_points, std::size_t num_dims)
+{
+    std::vector<double> points(num_points*num_dims);
+    for(std::size_t i = 0; i < points.size(); i++)
+    {
+        points[i] = std::sin(0.1*i);
+    }
+    return points;
+}
+
+TEST(Allocation, RepeatedSetDoesNotAllocate)
+{
+    const std::size_t num_points = 100;
+    const std::size_t num_dims = 3;
+    std::vector<double> points = make_points(num_points, num_dims);
+
+    Spline<double, Dynamic, Dynamic> spline;
+    spline.enable_coefficient_cache();
+    spline.set(points.data(), num_points, num_dims,
+        BoundaryCondition::Periodic, BoundaryCondition::Periodic);
+
+    AllocationCounter counter;
+    for(std::size_t n = num_points; n > num_points/2; n--)
+    {
+        spline.set(points.data(), n, num_dims,
+            BoundaryCondition::Periodic, BoundaryCondition::Periodic);
+        spline.set(points.data(), n, num_dims,
+            BoundaryCondition::Natural, BoundaryCondition::Hermite);
+    }
+    EXPECT_EQ(counter.count(), 0u);
+}
+
+TEST(Allocation, ReserveAvoidsAllocation)
+{
+    const std::size_t num_points = 100;
+    const std::size_t num_dims = 2;
+    std::vector<double> points = make_points(num_points, num_dims);
+
+    Spline<double, Dynamic, 2> spline;
+    spline.enable_coefficient_cache();
+    spline.reserve(num_points);
+
+    AllocationCounter counter;
+    for(std::size_t n = 2; n <= num_points; n++)
+    {
+        spline.set(points.data(), n,
+            BoundaryCondition::Periodic, BoundaryCondition::Periodic);
+    }
+    EXPECT_EQ(counter.count(), 0u);
+}
+
+TEST(Allocation, FixedSizeCacheAllocatesOnce)
+{
+    std::vector<double> points = make_points(16, 2);
+
+    Spline<double, 16, 2> spline;
+    spline.enable_coefficient_cache();
+    spline.set(points.data());
+
+    AllocationCounter counter;
+    for(int k = 0; k < 10; k++)
+    {
+        spline.set(points.data(), BoundaryCondition::Periodic, BoundaryCondition::Periodic);
+    }
+    EXPECT_EQ(counter.count(), 0u);
+}
+
+TEST(Allocation, SharedFactorizationHitDoesNotAllocate)
+{
+    const std::size_t num_points = 64;
+    const std::size_t num_dims = 2;
+    std::vector<double> points = make_points(num_points, num_dims);
+
+    Spline<double, Dynamic, Dynamic> first, second;
+    first.enable_factorization_cache();
+    second.enable_factorization_cache();
+    first.set(points.data(), num_points - 1, num_dims);
+    second.set(points.data(), num_points, num_dims);
+
+    AllocationCounter counter;
+    second.set(points.data(), num_points - 1, num_dims);
+    EXPECT_EQ(counter.count(), 0u);
+}
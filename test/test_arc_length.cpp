@@ -0,0 +1,118 @@
+/*
+ * MIT License
+ *
+ * Parametric Cubic Spline Library
+ * Copyright (c) 2021-, Michael Heidingsfeld
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "parametric_cubic_spline/arc_length.h"
+
+using namespace parametric_cubic_spline;
+
+TEST(ArcLength, UnevenSpacing)
+{
+    // Very uneven point spacing, the spline parameter runs at uneven speed
+    std::vector<double> points = { 0.0, 0.0, 0.5, 0.2, 4.0, 1.0, 4.5, 2.0, 5.0, 5.0 };
+    Spline<double, Dynamic, 2> spline;
+    spline.set(points.data(), 5);
+
+    ArcLength<double> arc_length;
+    arc_length.set(spline, 16);
+
+    // Reference cumulative length from a dense polyline
+    const std::size_t num_dense = 100001;
+    std::vector<double> pos(num_dense), dense(2*num_dense), cumulative(num_dense, 0.0);
+    for(std::size_t i = 0; i < num_dense; i++) pos[i] = double(i)/(num_dense - 1);
+    spline.eval(pos.data(), num_dense, dense.data());
+    for(std::size_t i = 1; i < num_dense; i++)
+    {
+        cumulative[i] = cumulative[i-1]
+            + std::hypot(dense[2*i] - dense[2*i-2], dense[2*i+1] - dense[2*i-1]);
+    }
+    EXPECT_NEAR(arc_length.length(), cumulative.back(), 1e-6);
+
+    // Arc length up to the parameter returned for s matches s
+    for(double s = 0.0; s < arc_length.length(); s += 0.05)
+    {
+        double u = arc_length.pos(s)*(num_dense - 1);
+        std::size_t i = std::min(static_cast<std::size_t>(u), num_dense - 2);
+        double reference = cumulative[i] + (u - i)*(cumulative[i+1] - cumulative[i]);
+        EXPECT_NEAR(reference, s, 1e-3);
+    }
+}
+
+TEST(ArcLength, Circle)
+{
+    // Natural spline through points on an open arc of the unit circle
+    const std::size_t num_points = 64;
+    std::vector<float> points(2*num_points);
+    for(std::size_t i = 0; i < num_points; i++)
+    {
+        // cluster points to get an uneven parameterization
+        double phi = 2.0*M_PI*std::pow(double(i)/num_points, 1.5);
+        points[2*i] = std::cos(phi);
+        points[2*i+1] = std::sin(phi);
+    }
+    Spline<float, Dynamic, 2> spline;
+    spline.set(points.data(), num_points);
+
+    ArcLength<float> arc_length;
+    arc_length.set(spline);
+
+    // Equally spaced arc lengths give equally spaced chords
+    const std::size_t num_samples = 100;
+    std::vector<float> samples(2*num_samples);
+    arc_length.resample(spline, num_samples, samples.data());
+    double step = arc_length.length()/(num_samples - 1);
+    for(std::size_t i = 1; i < num_samples; i++)
+    {
+        double dx = samples[2*i] - samples[2*(i-1)];
+        double dy = samples[2*i+1] - samples[2*(i-1)+1];
+        EXPECT_NEAR(std::sqrt(dx*dx + dy*dy), step, 1e-3);
+    }
+}
+
+TEST(ArcLength, InverseIsMonotone)
+{
+    std::vector<double> points = { 0.0, 1.0, 0.0, 2.0, 2.0, 5.0 };
+    Spline<double, Dynamic, 1> spline;
+    spline.set(points.data(), points.size());
+
+    ArcLength<double> arc_length;
+    arc_length.set(spline);
+
+    std::vector<double> s(200), pos(200);
+    for(std::size_t i = 0; i < s.size(); i++)
+    {
+        s[i] = arc_length.length()*i/(s.size() - 1);
+    }
+    arc_length.pos(s.data(), s.size(), pos.data());
+    EXPECT_DOUBLE_EQ(pos.front(), 0.0);
+    EXPECT_DOUBLE_EQ(pos.back(), 1.0);
+    for(std::size_t i = 1; i < pos.size(); i++)
+    {
+        EXPECT_GE(pos[i], pos[i-1]);
+    }
+}
@@ -0,0 +1,81 @@
+/*
+ * MIT License
+ *
+ * Parametric Cubic Spline Library
+ * Copyright (c) 2021-, Michael Heidingsfeld
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include <cmath>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "parametric_cubic_spline/incremental_solver.h"
+
+using namespace parametric_cubic_spline;
+
+template<typename Layout>
+static void check_incremental(const BoundaryCondition bc, const bool use_coefficient_cache)
+{
+    const std::size_t num_points = 301;
+    const std::size_t num_dims = 5;
+    std::vector<double> points(num_points*num_dims), old_points(num_points*num_dims, 1.0);
+    for(std::size_t i = 0; i < points.size(); i++) points[i] = std::sin(0.05*i);
+    const double left_tangent[num_dims] = {1.0, 0.5, 0.0, -0.5, -1.0};
+
+    Spline<double, Dynamic, Dynamic, Layout> expected, spline;
+    expected.enable_coefficient_cache(use_coefficient_cache);
+    spline.enable_coefficient_cache(use_coefficient_cache);
+    expected.set(points.data(), num_points, num_dims, BoundaryCondition::Hermite, bc, left_tangent);
+    spline.set(old_points.data(), num_points, num_dims);
+
+    IncrementalSolver<double, Dynamic, Dynamic, Layout> solver;
+    EXPECT_FALSE(solver.is_running());
+    solver.begin(spline, points.data(), num_points, num_dims, BoundaryCondition::Hermite, bc, left_tangent);
+
+    // the spline keeps its previous data until the last step
+    std::size_t num_steps = 0;
+    double out[num_dims], reference[num_dims];
+    while(!solver.step(7))
+    {
+        spline.eval(0.4, out);
+        EXPECT_EQ(out[0], 1.0);
+        num_steps++;
+    }
+    EXPECT_FALSE(solver.is_running());
+    // at least assembly and both sweeps, 7 rows per step
+    EXPECT_GE(num_steps, (3*num_points - 1)/7 - 1);
+
+    for(std::size_t k = 0; k <= 100; k++)
+    {
+        spline.eval(0.01*k, out);
+        expected.eval(0.01*k, reference);
+        for(std::size_t j = 0; j < num_dims; j++) EXPECT_EQ(out[j], reference[j]);
+    }
+}
+
+TEST(IncrementalSolver, MatchesSet)
+{
+    check_incremental<layout::AoS>(BoundaryCondition::Natural, true);
+    check_incremental<layout::AoS>(BoundaryCondition::Periodic, false);
+    check_incremental<layout::SoA>(BoundaryCondition::Periodic, true);
+    check_incremental<layout::AoSoA<4>>(BoundaryCondition::Natural, false);
+    check_incremental<layout::AoS>(BoundaryCondition::NotAKnot, true);
+    check_incremental<layout::AoSoA<4>>(BoundaryCondition::NotAKnot, false);
+}
@@ -0,0 +1,61 @@
+/*
+ * MIT License
+ *
+ * Parametric Cubic Spline Library
+ * Copyright (c) 2021-, Michael Heidingsfeld
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "parametric_cubic_spline/lazy_spline.h"
+
+using namespace parametric_cubic_spline;
+
+TEST(LazySpline, MatchesSpline)
+{
+    const std::size_t num_dims = 3;
+    for(std::size_t num_points : {2, 5, 40, 61, 100000})
+    {
+        std::vector<double> points(num_points*num_dims);
+        for(std::size_t i = 0; i < points.size(); i++) points[i] = 10.0*std::sin(0.7*i);
+
+        Spline<double, Dynamic, Dynamic> reference;
+        reference.enable_coefficient_cache();
+        reference.set(points.data(), num_points, num_dims);
+        LazySpline<double> spline;
+        spline.set(points.data(), num_points, num_dims);
+
+        // Both ends, the middle and a few segments in between, extrapolated
+        // positions grow with the number of points
+        std::vector<double> pos = {-0.01, 0.0, 1e-6, 0.5, 1.0 - 1e-6, 1.0, 1.01};
+        for(std::size_t k = 0; k < 50; k++) pos.push_back(double((k*7919) % 1000)/999);
+        for(double p : pos)
+        {
+            double expected[num_dims], actual[num_dims];
+            reference.eval(p, expected);
+            spline.eval(p, actual);
+            for(std::size_t j = 0; j < num_dims; j++) EXPECT_NEAR(actual[j], expected[j], 1e-9*std::max(1.0, std::abs(expected[j])));
+        }
+        EXPECT_LE(spline.num_computed_segments(), pos.size());
+    }
+}
@@ -0,0 +1,175 @@
+/*
+ * MIT License
+ *
+ * Parametric Cubic Spline Library
+ * Copyright (c) 2021-, Michael Heidingsfeld
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include <cmath>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "parametric_cubic_spline/non_uniform_spline.h"
+
+using namespace parametric_cubic_spline;
+
+TEST(NonUniformSpline, UniformMatchesSpline)
+{
+    const std::size_t num_points = 23;
+    const std::size_t num_dims = 3;
+    std::vector<double> points(num_points*num_dims);
+    for(std::size_t i = 0; i < points.size(); i++) points[i] = 10.0*std::sin(0.7*i);
+    // Spline takes tangents w.r.t. the point index, NonUniformSpline w.r.t. pos
+    const double tangent[num_dims] = {1.0, -2.0, 0.5};
+    const double scaled_tangent[num_dims] = {1.0*(num_points - 1), -2.0*(num_points - 1), 0.5*(num_points - 1)};
+
+    const BoundaryCondition bcs[] = {BoundaryCondition::Natural, BoundaryCondition::Hermite,
+        BoundaryCondition::Periodic, BoundaryCondition::NotAKnot};
+    for(BoundaryCondition bc : bcs)
+    {
+        Spline<double, Dynamic, Dynamic> reference;
+        reference.enable_coefficient_cache();
+        reference.set(points.data(), num_points, num_dims, bc, bc, tangent, tangent);
+        NonUniformSpline<double> spline;
+        spline.set(points.data(), num_points, num_dims, Parameterization::Uniform, bc, bc,
+            scaled_tangent, scaled_tangent);
+
+        for(std::size_t k = 0; k <= 200; k++)
+        {
+            const double pos = -0.05 + 1.1*k/200;
+            double expected[num_dims], actual[num_dims];
+            reference.eval(pos, expected);
+            spline.eval(pos, actual);
+            for(std::size_t j = 0; j < num_dims; j++) EXPECT_NEAR(actual[j], expected[j], 1e-9);
+        }
+    }
+}
+
+TEST(NonUniformSpline, ReproducesCubic)
+{
+    // Uneven and clustered knots, not-a-knot and exact Hermite tangents
+    // reproduce a cubic in the knot parameter
+    auto f = [](double u) { return 1.0 - 2.0*u + 3.0*u*u - 4.0*u*u*u; };
+    auto df = [](double u) { return -2.0 + 6.0*u - 12.0*u*u; };
+    std::vector<double> knots;
+    for(std::size_t i = 0; i < 30; i++) knots.push_back(std::pow(i/29.0, 3.0));
+    for(std::size_t i = 0; i < 10; i++) knots.push_back(1.0 + 0.5*(i + 1));
+    const std::size_t num_points = knots.size();
+    // knots need not start at zero, they are normalized to [0, 1]
+    std::vector<double> points(num_points), shifted(num_points);
+    const double length = knots.back();
+    for(std::size_t i = 0; i < num_points; i++)
+    {
+        points[i] = f(knots[i]/length);
+        shifted[i] = 3.0 + 2.0*knots[i];
+    }
+    const double left_tangent = df(0.0), right_tangent = df(1.0);
+
+    for(BoundaryCondition bc : {BoundaryCondition::NotAKnot, BoundaryCondition::Hermite})
+    {
+        NonUniformSpline<double> spline;
+        spline.set(points.data(), num_points, 1, shifted.data(), bc, bc, &left_tangent, &right_tangent);
+        EXPECT_EQ(spline.knots()[0], 0.0);
+        EXPECT_EQ(spline.knots()[num_points-1], 1.0);
+        for(std::size_t k = 0; k <= 1000; k++)
+        {
+            const double pos = k/1000.0;
+            double out;
+            spline.eval(pos, &out);
+            EXPECT_NEAR(out, f(pos), 1e-9);
+        }
+        for(std::size_t i = 0; i < num_points; i++)
+        {
+            double out;
+            spline.eval(spline.knots()[i], &out);
+            EXPECT_NEAR(out, points[i], 1e-12);
+        }
+    }
+}
+
+TEST(NonUniformSpline, ChordLength)
+{
+    // Points on a circle with uneven spacing, chord-length and centripetal
+    // knots interpolate and stay close to the circle, periodic closes it
+    const std::size_t num_points = 40;
+    std::vector<double> points(2*num_points);
+    for(std::size_t i = 0; i < num_points; i++)
+    {
+        const double phi = 2.0*M_PI*(i + 0.4*std::sin(1.0*i))/num_points;
+        points[2*i] = std::cos(phi);
+        points[2*i+1] = std::sin(phi);
+    }
+
+    for(Parameterization parameterization : {Parameterization::ChordLength, Parameterization::Centripetal})
+    {
+        NonUniformSpline<double> spline;
+        spline.set(points.data(), num_points, 2, parameterization,
+            BoundaryCondition::Periodic, BoundaryCondition::Periodic);
+        ASSERT_EQ(spline.num_points(), num_points);
+        for(std::size_t i = 0; i < num_points; i++)
+        {
+            double out[2];
+            spline.eval(spline.knots()[i], out);
+            EXPECT_NEAR(out[0], points[2*i], 1e-12);
+            EXPECT_NEAR(out[1], points[2*i+1], 1e-12);
+        }
+        std::vector<double> pos(500), out(1000);
+        for(std::size_t k = 0; k < pos.size(); k++) pos[k] = k/499.0;
+        spline.eval(pos.data(), pos.size(), out.data());
+        for(std::size_t k = 0; k < pos.size(); k++)
+        {
+            EXPECT_NEAR(std::hypot(out[2*k], out[2*k+1]), 1.0, 2e-3);
+        }
+    }
+}
+
+TEST(NonUniformSpline, MergesCoincidentPoints)
+{
+    // Repeated fixes, and a periodic end point repeating the first one
+    const std::vector<double> repeated = {0, 0, 1, 0, 1, 0, 2, 1, 3, 1, 3, 1, 0, 0};
+    const std::vector<double> distinct = {0, 0, 1, 0, 2, 1, 3, 1};
+    for(Parameterization parameterization : {Parameterization::ChordLength, Parameterization::Centripetal})
+    {
+        for(BoundaryCondition bc : {BoundaryCondition::Natural, BoundaryCondition::Periodic})
+        {
+            const std::size_t num_distinct = distinct.size()/2 + (bc == BoundaryCondition::Periodic ? 0 : 1);
+            std::vector<double> expected_points = distinct;
+            if(bc != BoundaryCondition::Periodic) expected_points.insert(expected_points.end(), {0, 0});
+
+            NonUniformSpline<double> reference, spline;
+            reference.set(expected_points.data(), num_distinct, 2, parameterization, bc, bc);
+            spline.set(repeated.data(), repeated.size()/2, 2, parameterization, bc, bc);
+            EXPECT_EQ(spline.num_points(), num_distinct);
+
+            for(std::size_t k = 0; k <= 100; k++)
+            {
+                const double pos = double(k)/100;
+                double expected[2], actual[2];
+                reference.eval(pos, expected);
+                spline.eval(pos, actual);
+                for(std::size_t j = 0; j < 2; j++)
+                {
+                    EXPECT_TRUE(std::isfinite(actual[j]));
+                    EXPECT_NEAR(actual[j], expected[j], 1e-12);
+                }
+            }
+        }
+    }
+}
@@ -23,6 +23,7 @@
  * SOFTWARE.
  */
 #include <initializer_list>
+#include <thread>
 #include <vector>
 #include <cmath>
 
@@ -194,4 +195,812 @@ TEST_P(TestFixture, FixedPointsFixedDims)
     {
         EXPECT_LT(fabs(eval_points[i] - problem.expected_points_[i]), 0.001);
     }
-}
\ No newline at end of file
+}
+
+TEST_P(TestFixture, CoefficientCache)
+{
+    TestProblem problem = GetParam();
+
+    Spline<float, Dynamic, Dynamic> spline;
+    spline.enable_coefficient_cache();
+    spline.set(
+        problem.points_.data(),
+        problem.num_points_,
+        problem.num_dims_,
+        problem.left_bc_,
+        problem.right_bc_,
+        problem.left_tangent_.data(),
+        problem.right_tangent_.data()
+    );
+
+    std::size_t eval_points_size = problem.eval_pos_.size()*problem.num_dims_;
+    std::vector<float> eval_points(eval_points_size, 0.0);
+    spline.eval(problem.eval_pos_.data(), 11, eval_points.data());
+
+    for(std::size_t i = 0; i < eval_points_size; i++)
+    {
+        EXPECT_LT(fabs(eval_points[i] - problem.expected_points_[i]), 0.001);
+    }
+}
+
+template<typename T>
+static void expect_batch_matches_scalar(std::size_t num_points, std::size_t num_dims, std::size_t num_pos, T tolerance)
+{
+    std::vector<T> points(num_points*num_dims);
+    for(std::size_t i = 0; i < points.size(); i++)
+    {
+        points[i] = std::sin(0.37*i) + 0.1*i;
+    }
+    std::vector<T> pos(num_pos);
+    for(std::size_t i = 0; i < num_pos; i++)
+    {
+        pos[i] = std::fmod(0.618*i, 1.0);
+    }
+    pos[0] = 0.0;
+    pos[num_pos-1] = 1.0;
+
+    Spline<T, Dynamic, Dynamic> reference, spline;
+    reference.set(points.data(), num_points, num_dims, BoundaryCondition::Periodic, BoundaryCondition::Periodic);
+    spline.enable_coefficient_cache();
+    spline.set(points.data(), num_points, num_dims, BoundaryCondition::Periodic, BoundaryCondition::Periodic);
+
+    std::vector<T> expected(num_pos*num_dims), actual(num_pos*num_dims);
+    for(std::size_t i = 0; i < num_pos; i++)
+    {
+        reference.eval(pos[i], &expected[i*num_dims]);
+    }
+    spline.eval(pos.data(), num_pos, actual.data());
+
+    for(std::size_t i = 0; i < expected.size(); i++)
+    {
+        EXPECT_NEAR(actual[i], expected[i], tolerance*(1.0 + std::fabs(expected[i])));
+    }
+}
+
+TEST(BatchEval, MatchesScalarFloat)
+{
+    expect_batch_matches_scalar<float>(2, 1, 5, 1e-3f);
+    expect_batch_matches_scalar<float>(17, 3, 101, 1e-3f);
+    expect_batch_matches_scalar<float>(64, 7, 1000, 1e-3f);
+}
+
+TEST(BatchEval, MatchesScalarDouble)
+{
+    expect_batch_matches_scalar<double>(2, 1, 5, 1e-12);
+    expect_batch_matches_scalar<double>(17, 3, 101, 1e-12);
+    expect_batch_matches_scalar<double>(64, 7, 1000, 1e-12);
+}
+
+TEST_P(TestFixture, FactorizationCache)
+{
+    TestProblem problem = GetParam();
+
+    Spline<float, Dynamic, Dynamic> spline;
+    spline.enable_factorization_cache();
+
+    // Fit unrelated data of the same size first, the factorization is reused
+    std::vector<float> other(problem.points_.size(), 1.0);
+    spline.set(other.data(), problem.num_points_, problem.num_dims_,
+        problem.left_bc_, problem.right_bc_);
+    spline.set(
+        problem.points_.data(),
+        problem.num_points_,
+        problem.num_dims_,
+        problem.left_bc_,
+        problem.right_bc_,
+        problem.left_tangent_.data(),
+        problem.right_tangent_.data()
+    );
+
+    std::size_t eval_points_size = problem.eval_pos_.size()*problem.num_dims_;
+    std::vector<float> eval_points(eval_points_size, 0.0);
+    spline.eval(problem.eval_pos_.data(), 11, eval_points.data());
+
+    for(std::size_t i = 0; i < eval_points_size; i++)
+    {
+        EXPECT_LT(fabs(eval_points[i] - problem.expected_points_[i]), 0.001);
+    }
+}
+
+TEST(FactorizationCache, ConcurrentSet)
+{
+    const std::size_t num_points = 50;
+    const std::size_t num_dims = 2;
+    const BoundaryCondition bcs[] = { BoundaryCondition::Natural, BoundaryCondition::Periodic };
+    std::vector<double> points(num_points*num_dims);
+    for(std::size_t i = 0; i < points.size(); i++)
+    {
+        points[i] = std::cos(0.3*i);
+    }
+
+    Spline<double, Dynamic, Dynamic>::clear_factorization_cache();
+    std::vector<std::thread> threads;
+    std::vector<int> failures(8, 0);
+    for(std::size_t k = 0; k < failures.size(); k++)
+    {
+        threads.emplace_back([&, k]() {
+            Spline<double, Dynamic, Dynamic> reference, spline;
+            spline.enable_factorization_cache();
+            for(std::size_t iter = 0; iter < 100; iter++)
+            {
+                std::size_t n = num_points - (iter + k) % 5;
+                BoundaryCondition bc = bcs[(iter + k) % 2];
+                reference.set(points.data(), n, num_dims, bc, bc);
+                spline.set(points.data(), n, num_dims, bc, bc);
+                for(double pos = 0.0; pos <= 1.0; pos += 0.05)
+                {
+                    double expected[num_dims], actual[num_dims];
+                    reference.eval(pos, expected);
+                    spline.eval(pos, actual);
+                    for(std::size_t j = 0; j < num_dims; j++)
+                    {
+                        if(std::fabs(expected[j] - actual[j]) > 1e-12) failures[k]++;
+                    }
+                }
+            }
+        });
+    }
+    for(auto &thread : threads) thread.join();
+
+    for(int count : failures)
+    {
+        EXPECT_EQ(count, 0);
+    }
+}
+
+TEST(Derivatives, ReproduceCubic)
+{
+    // f(u) = 1 - 2u + 3u^2 + 4u^3 is reproduced exactly by a spline with
+    // Hermite boundary conditions, tangents are given w.r.t. the local parameter
+    const std::size_t num_points = 7;
+    auto f = [](double u) { return 1.0 - 2.0*u + 3.0*u*u + 4.0*u*u*u; };
+    auto df = [](double u) { return -2.0 + 6.0*u + 12.0*u*u; };
+    auto ddf = [](double u) { return 6.0 + 24.0*u; };
+
+    std::vector<double> points(num_points);
+    for(std::size_t i = 0; i < num_points; i++)
+    {
+        points[i] = f(double(i)/(num_points - 1));
+    }
+    double left_tangent = df(0.0)/(num_points - 1);
+    double right_tangent = df(1.0)/(num_points - 1);
+
+    std::vector<double> pos;
+    for(double u = 0.0; u <= 1.0; u += 0.03) pos.push_back(u);
+    pos.push_back(1.0);
+
+    for(bool use_coefficient_cache : { false, true })
+    {
+        Spline<double, Dynamic, 1> spline;
+        spline.enable_coefficient_cache(use_coefficient_cache);
+        spline.set(points.data(), num_points, BoundaryCondition::Hermite, BoundaryCondition::Hermite,
+            &left_tangent, &right_tangent);
+
+        std::vector<double> p(pos.size()), d1(pos.size()), d2(pos.size()), d3(pos.size());
+        spline.eval(pos.data(), pos.size(), p.data(), d1.data(), d2.data(), d3.data());
+
+        for(std::size_t k = 0; k < pos.size(); k++)
+        {
+            EXPECT_NEAR(p[k], f(pos[k]), 1e-9);
+            EXPECT_NEAR(d1[k], df(pos[k]), 1e-8);
+            EXPECT_NEAR(d2[k], ddf(pos[k]), 1e-7);
+            EXPECT_NEAR(d3[k], 24.0, 1e-6);
+        }
+    }
+}
+
+TEST(NotAKnot, ReproducesCubic)
+{
+    // A single cubic through all points is reproduced for any number of
+    // points from four on, three points reproduce a parabola
+    auto cubic = [](double u) { return 1.0 - 2.0*u + 3.0*u*u + 4.0*u*u*u; };
+    auto parabola = [](double u) { return 2.0 + u - 5.0*u*u; };
+
+    for(std::size_t num_points : {3, 4, 5, 9, 40})
+    {
+        auto f = [&](double u) { return num_points > 3 ? cubic(u) : parabola(u); };
+        std::vector<double> points(2*num_points);
+        for(std::size_t i = 0; i < num_points; i++)
+        {
+            points[2*i] = f(double(i)/(num_points - 1));
+            points[2*i+1] = -f(double(i)/(num_points - 1));
+        }
+
+        for(bool use_coefficient_cache : { false, true })
+        {
+            Spline<double, Dynamic, 2> spline;
+            spline.enable_coefficient_cache(use_coefficient_cache);
+            spline.set(points.data(), num_points, BoundaryCondition::NotAKnot, BoundaryCondition::NotAKnot);
+            for(std::size_t k = 0; k <= 100; k++)
+            {
+                const double u = 0.01*k;
+                double out[2];
+                spline.eval(u, out);
+                EXPECT_NEAR(out[0], f(u), 1e-9);
+                EXPECT_NEAR(out[1], -f(u), 1e-9);
+            }
+        }
+    }
+
+    // One-sided, the third derivative is continuous across the second point
+    const std::size_t num_points = 9;
+    std::vector<double> points(num_points);
+    for(std::size_t i = 0; i < num_points; i++) points[i] = std::sin(1.3*i);
+    for(std::size_t n : {std::size_t(3), std::size_t(4), num_points})
+    {
+        Spline<double, Dynamic, 1> spline;
+        spline.set(points.data(), n, BoundaryCondition::NotAKnot, BoundaryCondition::Hermite);
+        std::vector<double> pos = {0.5/(n - 1), 1.5/(n - 1)};
+        std::vector<double> d3(2);
+        spline.eval(pos.data(), 2, nullptr, nullptr, nullptr, d3.data());
+        EXPECT_NEAR(d3[0], d3[1], 1e-9);
+    }
+}
+
+TEST(Derivatives, SecondDerivativeInterpolatesMoments)
+{
+    const std::size_t num_points = 5;
+    const std::size_t num_dims = 2;
+    std::vector<float> points = { 0.0, 0.0, 1.0, 2.0, 2.0, 1.0, 3.0, 3.0, 4.0, 0.0 };
+
+    Spline<float, Dynamic, Dynamic> spline;
+    spline.set(points.data(), num_points, num_dims);
+
+    // Natural boundary conditions, zero curvature at the end points
+    std::vector<float> pos = { 0.0, 1.0 };
+    std::vector<float> p(4), d2(4);
+    spline.eval(pos.data(), pos.size(), p.data(), nullptr, d2.data());
+    for(std::size_t k = 0; k < 4; k++)
+    {
+        EXPECT_NEAR(d2[k], 0.0, 1e-4);
+    }
+    EXPECT_NEAR(p[0], 0.0, 1e-5);
+    EXPECT_NEAR(p[2], 4.0, 1e-5);
+    EXPECT_NEAR(p[3], 0.0, 1e-5);
+}
+
+TEST(Cursor, MatchesEval)
+{
+    const std::size_t num_points = 20;
+    const std::size_t num_dims = 3;
+    std::vector<double> points(num_points*num_dims);
+    for(std::size_t i = 0; i < points.size(); i++)
+    {
+        points[i] = std::sin(0.7*i);
+    }
+
+    // Ascending, repeated, descending and jumping positions
+    std::vector<double> pos;
+    for(double u = 0.0; u <= 1.0; u += 0.013) pos.push_back(u);
+    pos.push_back(1.0);
+    pos.push_back(1.0);
+    for(double u = 1.0; u >= 0.0; u -= 0.031) pos.push_back(u);
+    pos.push_back(0.5);
+    pos.push_back(0.02);
+    pos.push_back(0.97);
+
+    for(bool use_coefficient_cache : { false, true })
+    {
+        Spline<double, Dynamic, Dynamic> spline;
+        spline.enable_coefficient_cache(use_coefficient_cache);
+        spline.set(points.data(), num_points, num_dims);
+
+        std::vector<double> expected(pos.size()*num_dims), actual(pos.size()*num_dims);
+        for(std::size_t i = 0; i < pos.size(); i++)
+        {
+            spline.eval(pos[i], &expected[i*num_dims]);
+        }
+        Spline<double, Dynamic, Dynamic>::Cursor cursor;
+        spline.eval(cursor, pos.data(), pos.size(), actual.data());
+
+        for(std::size_t i = 0; i < expected.size(); i++)
+        {
+            EXPECT_NEAR(actual[i], expected[i], 1e-12);
+        }
+    }
+}
+
+TEST(Cursor, InvalidatedBySet)
+{
+    std::vector<float> first = { 0.0, 0.0, 1.0, 1.0, 2.0, 0.0 };
+    std::vector<float> second = { 0.0, 0.0, -1.0, -1.0, -2.0, 0.0 };
+
+    Spline<float, Dynamic, 2> spline;
+    Spline<float, Dynamic, 2>::Cursor cursor;
+    float out[2];
+
+    spline.set(first.data(), 3);
+    spline.eval(cursor, 0.5f, out);
+    EXPECT_NEAR(out[0], 1.0, 1e-6);
+
+    // Same segment, new data
+    spline.set(second.data(), 3);
+    spline.eval(cursor, 0.5f, out);
+    EXPECT_NEAR(out[0], -1.0, 1e-6);
+    EXPECT_NEAR(out[1], -1.0, 1e-6);
+
+    // Copied cursors remain valid
+    Spline<float, Dynamic, 2>::Cursor copy = cursor;
+    spline.eval(copy, 0.5f, out);
+    EXPECT_NEAR(out[0], -1.0, 1e-6);
+}
+
+template<typename T>
+static void expect_uniform_matches_eval(std::size_t num_points, std::size_t num_samples, double tolerance)
+{
+    const std::size_t num_dims = 2;
+    std::vector<T> points(num_points*num_dims);
+    for(std::size_t i = 0; i < points.size(); i++)
+    {
+        points[i] = 10.0*std::sin(0.9*i);
+    }
+
+    Spline<T, Dynamic, Dynamic> spline;
+    spline.set(points.data(), num_points, num_dims, BoundaryCondition::Periodic, BoundaryCondition::Periodic);
+
+    std::vector<T> expected(num_samples*num_dims), actual(num_samples*num_dims);
+    for(std::size_t k = 0; k < num_samples; k++)
+    {
+        T pos = num_samples > 1 ? T(k)/(num_samples - 1) : 0.0;
+        spline.eval(pos, &expected[k*num_dims]);
+    }
+    spline.eval_uniform(num_samples, actual.data());
+
+    for(std::size_t i = 0; i < expected.size(); i++)
+    {
+        EXPECT_NEAR(actual[i], expected[i], tolerance);
+    }
+}
+
+TEST(EvalUniform, MatchesEval)
+{
+    expect_uniform_matches_eval<double>(10, 1, 1e-12);
+    expect_uniform_matches_eval<double>(10, 2, 1e-12);
+    expect_uniform_matches_eval<double>(10, 4, 1e-12);
+    expect_uniform_matches_eval<double>(10, 10, 1e-12);
+    expect_uniform_matches_eval<double>(10, 1001, 1e-10);
+    expect_uniform_matches_eval<double>(3, 100000, 1e-8);
+    expect_uniform_matches_eval<float>(10, 1001, 1e-3);
+    expect_uniform_matches_eval<float>(3, 100000, 1e-3);
+}
+
+static void expect_partitioned_matches_serial(BoundaryCondition bc)
+{
+    const std::size_t num_points = 3*8192 + 17;
+    const std::size_t num_dims = 2;
+    std::vector<double> points(num_points*num_dims);
+    for(std::size_t i = 0; i < points.size(); i++)
+    {
+        points[i] = 10.0*std::sin(0.37*i) + 0.01*i;
+    }
+    std::vector<double> tangents = {1.0, -2.0};
+
+    Spline<double, Dynamic, Dynamic> serial;
+    serial.set_num_threads(1);
+    serial.set(points.data(), num_points, num_dims, bc, bc, tangents.data(), tangents.data());
+
+    const std::size_t num_pos = 4096;
+    std::vector<double> pos(num_pos);
+    for(std::size_t k = 0; k < num_pos; k++)
+    {
+        pos[k] = double(k)/(num_pos - 1);
+    }
+    std::vector<double> expected(num_pos*num_dims);
+    serial.eval(pos.data(), num_pos, expected.data());
+
+    std::vector<double> first;
+    for(std::size_t num_threads : {2, 4, 0})
+    {
+        Spline<double, Dynamic, Dynamic> parallel;
+        parallel.set_num_threads(num_threads);
+        parallel.set(points.data(), num_points, num_dims, bc, bc, tangents.data(), tangents.data());
+
+        std::vector<double> actual(num_pos*num_dims);
+        parallel.eval(pos.data(), num_pos, actual.data());
+        for(std::size_t i = 0; i < actual.size(); i++)
+        {
+            EXPECT_NEAR(actual[i], expected[i], 1e-9);
+        }
+
+        // Same result regardless of the number of threads
+        if(first.empty()) first = actual;
+        EXPECT_EQ(actual, first);
+    }
+}
+
+TEST(PartitionedSolver, MatchesSerial)
+{
+    expect_partitioned_matches_serial(BoundaryCondition::Natural);
+    expect_partitioned_matches_serial(BoundaryCondition::Hermite);
+    expect_partitioned_matches_serial(BoundaryCondition::Periodic);
+    expect_partitioned_matches_serial(BoundaryCondition::NotAKnot);
+}
+
+template<typename T>
+static void expect_batch_matches_set(BoundaryCondition bc, double tolerance)
+{
+    const std::size_t num_splines = 37;
+    const std::size_t num_points = 12;
+    const std::size_t num_dims = 3;
+    std::vector<T> points(num_splines*num_points*num_dims);
+    std::vector<T> tangents(2*num_splines*num_dims);
+    for(std::size_t i = 0; i < points.size(); i++)
+    {
+        points[i] = 10.0*std::sin(0.7*i);
+    }
+    for(std::size_t i = 0; i < tangents.size(); i++)
+    {
+        tangents[i] = std::cos(1.3*i);
+    }
+
+    std::vector<const T*> batch_points(num_splines), left_tangents(num_splines), right_tangents(num_splines);
+    for(std::size_t k = 0; k < num_splines; k++)
+    {
+        batch_points[k] = &points[k*num_points*num_dims];
+        left_tangents[k] = &tangents[2*k*num_dims];
+        right_tangents[k] = &tangents[(2*k+1)*num_dims];
+    }
+
+    std::vector<Spline<T, Dynamic, Dynamic>> splines(num_splines);
+    for(std::size_t k = 0; k < num_splines; k += 2)
+    {
+        splines[k].enable_coefficient_cache();
+    }
+    Spline<T, Dynamic, Dynamic>::set_batch(splines.data(), batch_points.data(), num_splines,
+        num_points, num_dims, bc, bc, left_tangents.data(), right_tangents.data());
+
+    const std::size_t num_pos = 101;
+    std::vector<T> pos(num_pos);
+    for(std::size_t p = 0; p < num_pos; p++)
+    {
+        pos[p] = T(p)/(num_pos - 1);
+    }
+    for(std::size_t k = 0; k < num_splines; k++)
+    {
+        Spline<T, Dynamic, Dynamic> reference;
+        reference.set(batch_points[k], num_points, num_dims, bc, bc, left_tangents[k], right_tangents[k]);
+
+        std::vector<T> expected(num_pos*num_dims), actual(num_pos*num_dims);
+        reference.eval(pos.data(), num_pos, expected.data());
+        splines[k].eval(pos.data(), num_pos, actual.data());
+        for(std::size_t i = 0; i < expected.size(); i++)
+        {
+            EXPECT_NEAR(actual[i], expected[i], tolerance);
+        }
+    }
+}
+
+TEST(SetBatch, MatchesSet)
+{
+    expect_batch_matches_set<double>(BoundaryCondition::Natural, 1e-12);
+    expect_batch_matches_set<double>(BoundaryCondition::Hermite, 1e-12);
+    expect_batch_matches_set<double>(BoundaryCondition::Periodic, 1e-12);
+    expect_batch_matches_set<double>(BoundaryCondition::NotAKnot, 1e-12);
+    expect_batch_matches_set<float>(BoundaryCondition::Natural, 1e-4);
+    expect_batch_matches_set<float>(BoundaryCondition::Periodic, 1e-4);
+}
+
+template<typename T, std::size_t NumPoints>
+static void expect_fixed_matches_dynamic(double tolerance, std::size_t num_points = NumPoints)
+{
+    const std::size_t num_dims = 3;
+    std::vector<T> points(NumPoints*num_dims);
+    for(std::size_t i = 0; i < points.size(); i++)
+    {
+        points[i] = 10.0*std::sin(0.7*i);
+    }
+    const T left_tangent[num_dims] = {1.0, -2.0, 0.5};
+    const T right_tangent[num_dims] = {-1.0, 0.0, 3.0};
+
+    const BoundaryCondition bcs[] = {BoundaryCondition::Natural, BoundaryCondition::Hermite,
+        BoundaryCondition::Periodic, BoundaryCondition::NotAKnot};
+    for(BoundaryCondition left_bc : bcs)
+    {
+        for(BoundaryCondition right_bc : bcs)
+        {
+            if((left_bc == BoundaryCondition::Periodic) != (right_bc == BoundaryCondition::Periodic)) continue;
+
+            Spline<T, Dynamic, Dynamic> reference;
+            reference.set(points.data(), num_points, num_dims, left_bc, right_bc, left_tangent, right_tangent);
+            Spline<T, NumPoints, num_dims> spline;
+            spline.set(points.data(), num_points, left_bc, right_bc, left_tangent, right_tangent);
+
+            const std::size_t num_pos = 101;
+            std::vector<T> pos(num_pos), expected(num_pos*num_dims), actual(num_pos*num_dims);
+            for(std::size_t p = 0; p < num_pos; p++)
+            {
+                pos[p] = T(p)/(num_pos - 1);
+            }
+            reference.eval(pos.data(), num_pos, expected.data());
+            spline.eval(pos.data(), num_pos, actual.data());
+            for(std::size_t i = 0; i < expected.size(); i++)
+            {
+                EXPECT_NEAR(actual[i], expected[i], tolerance);
+            }
+        }
+    }
+}
+
+TEST(FixedSolver, MatchesDynamic)
+{
+    expect_fixed_matches_dynamic<double, 2>(1e-12);
+    expect_fixed_matches_dynamic<double, 3>(1e-12);
+    expect_fixed_matches_dynamic<double, 8>(1e-12);
+    expect_fixed_matches_dynamic<double, 32>(1e-12);
+    expect_fixed_matches_dynamic<float, 8>(1e-4);
+
+    // Fewer points than the fixed size take the generic solver
+    expect_fixed_matches_dynamic<double, 8>(1e-12, 5);
+    expect_fixed_matches_dynamic<double, 32>(1e-12, 3);
+}
+
+template<typename Layout, std::size_t NumPoints>
+static void expect_layout_matches_aos(std::size_t num_points, BoundaryCondition bc)
+{
+    const std::size_t num_dims = 6;
+    std::vector<double> points(num_points*num_dims);
+    for(std::size_t i = 0; i < points.size(); i++)
+    {
+        points[i] = 10.0*std::sin(0.7*i);
+    }
+
+    const std::size_t num_pos = 103;
+    std::vector<double> pos(num_pos);
+    for(std::size_t p = 0; p < num_pos; p++)
+    {
+        pos[p] = double(p)/(num_pos - 1);
+    }
+
+    for(bool cache : {false, true})
+    {
+        Spline<double, NumPoints, num_dims> reference;
+        Spline<double, NumPoints, num_dims, Layout> spline;
+        reference.enable_coefficient_cache(cache);
+        spline.enable_coefficient_cache(cache);
+        reference.set(points.data(), num_points, bc, bc);
+        spline.set(points.data(), num_points, bc, bc);
+
+        std::vector<double> expected(num_pos*num_dims), actual(num_pos*num_dims);
+        std::vector<double> expected_first(num_pos*num_dims), actual_first(num_pos*num_dims);
+        reference.eval(pos.data(), num_pos, expected.data());
+        spline.eval(pos.data(), num_pos, actual.data());
+        for(std::size_t i = 0; i < expected.size(); i++)
+        {
+            EXPECT_NEAR(actual[i], expected[i], 1e-10);
+        }
+
+        reference.eval(pos.data(), num_pos, nullptr, expected_first.data(), nullptr);
+        spline.eval(pos.data(), num_pos, nullptr, actual_first.data(), nullptr);
+        for(std::size_t i = 0; i < expected.size(); i++)
+        {
+            EXPECT_NEAR(actual_first[i], expected_first[i], 1e-8);
+        }
+
+        typename Spline<double, NumPoints, num_dims, Layout>::Cursor cursor;
+        spline.eval(cursor, pos.data(), num_pos, actual.data());
+        for(std::size_t i = 0; i < expected.size(); i++)
+        {
+            EXPECT_NEAR(actual[i], expected[i], 1e-10);
+        }
+
+        spline.eval_uniform(num_pos, actual.data());
+        for(std::size_t i = 0; i < expected.size(); i++)
+        {
+            EXPECT_NEAR(actual[i], expected[i], 1e-10);
+        }
+    }
+}
+
+TEST(Layout, MatchesAoS)
+{
+    expect_layout_matches_aos<layout::SoA, Dynamic>(17, BoundaryCondition::Natural);
+    expect_layout_matches_aos<layout::SoA, Dynamic>(17, BoundaryCondition::Periodic);
+    expect_layout_matches_aos<layout::AoSoA<4>, Dynamic>(17, BoundaryCondition::Natural);
+    expect_layout_matches_aos<layout::AoSoA<4>, Dynamic>(17, BoundaryCondition::Periodic);
+    expect_layout_matches_aos<layout::AoSoA<4>, Dynamic>(2*8192 + 5, BoundaryCondition::Natural);
+    expect_layout_matches_aos<layout::SoA, 8>(8, BoundaryCondition::Hermite);
+    expect_layout_matches_aos<layout::AoSoA<4>, 8>(8, BoundaryCondition::Periodic);
+}
+
+TEST(Layout, SetBatch)
+{
+    const std::size_t num_splines = 5;
+    const std::size_t num_points = 9;
+    const std::size_t num_dims = 3;
+    std::vector<double> points(num_splines*num_points*num_dims);
+    std::vector<const double*> batch_points(num_splines);
+    for(std::size_t i = 0; i < points.size(); i++)
+    {
+        points[i] = 10.0*std::sin(0.7*i);
+    }
+    for(std::size_t k = 0; k < num_splines; k++)
+    {
+        batch_points[k] = &points[k*num_points*num_dims];
+    }
+
+    std::vector<Spline<double, Dynamic, Dynamic, layout::AoSoA<2>>> splines(num_splines);
+    Spline<double, Dynamic, Dynamic, layout::AoSoA<2>>::set_batch(splines.data(), batch_points.data(),
+        num_splines, num_points, num_dims);
+
+    for(std::size_t k = 0; k < num_splines; k++)
+    {
+        Spline<double, Dynamic, Dynamic> reference;
+        reference.set(batch_points[k], num_points, num_dims);
+        for(double pos : {0.0, 0.13, 0.5, 0.77, 1.0})
+        {
+            double expected[num_dims], actual[num_dims];
+            reference.eval(pos, expected);
+            splines[k].eval(pos, actual);
+            for(std::size_t j = 0; j < num_dims; j++)
+            {
+                EXPECT_NEAR(actual[j], expected[j], 1e-12);
+            }
+        }
+    }
+}
+
+template<typename Layout>
+static void expect_channels_match_single(std::size_t num_points, std::size_t num_dims, BoundaryCondition bc)
+{
+    std::vector<double> points(num_points*num_dims);
+    for(std::size_t i = 0; i < points.size(); i++)
+    {
+        points[i] = 10.0*std::sin(0.7*i);
+    }
+
+    const std::size_t num_pos = 200;
+    std::vector<double> pos(num_pos);
+    for(std::size_t p = 0; p < num_pos; p++)
+    {
+        pos[p] = double(p)/(num_pos - 1);
+    }
+
+    Spline<double, Dynamic, Dynamic> reference;
+    reference.set(points.data(), num_points, num_dims, bc, bc);
+    std::vector<double> expected(num_pos*num_dims);
+    for(std::size_t p = 0; p < num_pos; p++)
+    {
+        reference.eval(pos[p], &expected[p*num_dims]);
+    }
+
+    std::vector<double> first;
+    for(std::size_t num_threads : {1, 2, 0})
+    {
+        Spline<double, Dynamic, Dynamic, Layout> spline;
+        spline.set_num_threads(num_threads);
+        spline.set(points.data(), num_points, num_dims, bc, bc);
+        std::vector<double> actual(num_pos*num_dims);
+        spline.eval(pos.data(), num_pos, actual.data());
+        for(std::size_t i = 0; i < expected.size(); i++)
+        {
+            EXPECT_NEAR(actual[i], expected[i], 1e-9);
+        }
+
+        // Same result regardless of the number of threads
+        if(first.empty()) first = actual;
+        EXPECT_EQ(actual, first);
+    }
+}
+
+TEST(Multichannel, MatchesSingle)
+{
+    expect_channels_match_single<layout::AoS>(9, 41, BoundaryCondition::Natural);
+    expect_channels_match_single<layout::AoS>(130, 600, BoundaryCondition::Natural);
+    expect_channels_match_single<layout::AoS>(130, 600, BoundaryCondition::Periodic);
+    expect_channels_match_single<layout::AoSoA<16>>(130, 600, BoundaryCondition::Periodic);
+    expect_channels_match_single<layout::SoA>(130, 600, BoundaryCondition::Natural);
+}
+
+TEST(ParallelEval, MatchesSerial)
+{
+    const std::size_t num_points = 50;
+    const std::size_t num_dims = 3;
+    const std::size_t num_pos = 30001;
+    std::vector<double> points(num_points*num_dims);
+    for(std::size_t i = 0; i < points.size(); i++)
+    {
+        points[i] = 10.0*std::sin(0.7*i);
+    }
+    std::vector<double> pos(num_pos);
+    for(std::size_t p = 0; p < num_pos; p++)
+    {
+        pos[p] = double((p*7919) % num_pos)/(num_pos - 1);
+    }
+
+    for(bool cache : {false, true})
+    {
+        Spline<double, Dynamic, Dynamic> spline;
+        spline.enable_coefficient_cache(cache);
+        spline.set(points.data(), num_points, num_dims);
+        const Spline<double, Dynamic, Dynamic> &shared = spline;
+
+        std::vector<double> expected(num_pos*num_dims);
+        shared.eval(pos.data(), num_pos, expected.data());
+
+        for(std::size_t num_threads : {2, 0})
+        {
+            std::vector<double> actual(num_pos*num_dims);
+            shared.eval_parallel(pos.data(), num_pos, actual.data(), num_threads);
+            EXPECT_EQ(actual, expected);
+        }
+
+        // Concurrent readers of the same spline
+        std::vector<std::vector<double>> results(4, std::vector<double>(num_pos*num_dims));
+        std::vector<std::thread> threads;
+        for(std::size_t k = 0; k < results.size(); k++)
+        {
+            threads.emplace_back([&, k]() {
+                if(k % 2) shared.eval_parallel(pos.data(), num_pos, results[k].data(), 2);
+                else shared.eval(pos.data(), num_pos, results[k].data());
+            });
+        }
+        for(auto &thread : threads) thread.join();
+        for(auto &result : results)
+        {
+            EXPECT_EQ(result, expected);
+        }
+    }
+}
+
+template<typename Layout>
+void expect_update_matches_set(
+    const std::size_t num_points,
+    const BoundaryCondition bc,
+    const bool cache
+)
+{
+    const std::size_t num_dims = 3;
+    std::vector<double> points(num_points*num_dims);
+    for(std::size_t i = 0; i < points.size(); i++)
+    {
+        points[i] = 10.0*std::sin(0.7*i);
+    }
+
+    const std::size_t num_pos = 2001;
+    std::vector<double> pos(num_pos);
+    for(std::size_t p = 0; p < num_pos; p++)
+    {
+        pos[p] = double(p)/(num_pos - 1);
+    }
+
+    Spline<double, Dynamic, Dynamic, Layout> spline;
+    spline.enable_coefficient_cache(cache);
+    spline.set(points.data(), num_points, num_dims, bc, bc);
+
+    // Moves at both ends and in the middle, accumulated
+    for(std::size_t i : {std::size_t(0), std::size_t(1), num_points/2, num_points - 2, num_points - 1})
+    {
+        std::vector<double> old_point(&points[i*num_dims], &points[(i+1)*num_dims]);
+        for(std::size_t j = 0; j < num_dims; j++)
+        {
+            points[i*num_dims+j] += 3.0 + j;
+        }
+        spline.update_point(i, old_point.data());
+
+        Spline<double, Dynamic, Dynamic, Layout> reference;
+        reference.set(points.data(), num_points, num_dims, bc, bc);
+        std::vector<double> expected(num_pos*num_dims);
+        std::vector<double> actual(num_pos*num_dims);
+        reference.eval(pos.data(), num_pos, expected.data());
+        spline.eval(pos.data(), num_pos, actual.data());
+        for(std::size_t k = 0; k < expected.size(); k++)
+        {
+            EXPECT_NEAR(actual[k], expected[k], 1e-9);
+        }
+    }
+}
+
+TEST(UpdatePoint, MatchesSet)
+{
+    for(BoundaryCondition bc : {BoundaryCondition::Natural, BoundaryCondition::Hermite,
+        BoundaryCondition::Periodic, BoundaryCondition::NotAKnot})
+    {
+        for(bool cache : {false, true})
+        {
+            expect_update_matches_set<layout::AoS>(20, bc, cache);
+            expect_update_matches_set<layout::AoS>(5000, bc, cache);
+        }
+        expect_update_matches_set<layout::SoA>(5000, bc, true);
+        expect_update_matches_set<layout::AoSoA<4>>(5000, bc, false);
+    }
+}
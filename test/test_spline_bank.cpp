@@ -0,0 +1,97 @@
+/*
+ * MIT License
+ *
+ * Parametric Cubic Spline Library
+ * Copyright (c) 2021-, Michael Heidingsfeld
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include <cmath>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "parametric_cubic_spline/spline_bank.h"
+
+using namespace parametric_cubic_spline;
+
+TEST(SplineBank, MatchesSplines)
+{
+    const std::size_t num_splines = 50;
+    const std::size_t num_dims = 2;
+    std::vector<std::vector<double>> points(num_splines);
+    std::vector<Spline<double, Dynamic, Dynamic>> splines(num_splines);
+    SplineBank<double> bank(num_dims);
+    bank.reserve(num_splines, 0);
+
+    std::size_t total_points = 0;
+    for(std::size_t k = 0; k < num_splines; k++)
+    {
+        const std::size_t num_points = 2 + (k*7) % 23;
+        const BoundaryCondition bc = k % 3 ? BoundaryCondition::Natural : BoundaryCondition::Periodic;
+        points[k].resize(num_points*num_dims);
+        for(std::size_t i = 0; i < points[k].size(); i++)
+        {
+            points[k][i] = 10.0*std::sin(0.7*i + k);
+        }
+        splines[k].enable_coefficient_cache();
+        splines[k].set(points[k].data(), num_points, num_dims, bc, bc);
+        EXPECT_EQ(bank.add(points[k].data(), num_points, bc, bc), k);
+        EXPECT_EQ(bank.num_points(k), num_points);
+        total_points += num_points;
+    }
+    EXPECT_EQ(bank.size(), num_splines);
+    EXPECT_GE(bank.memory_footprint(), 4*(total_points - num_splines)*num_dims*sizeof(double));
+
+    // Queries in random order, including positions slightly outside [0, 1]
+    const std::size_t num_queries = 40000;
+    std::vector<std::size_t> ids(num_queries);
+    std::vector<double> pos(num_queries);
+    for(std::size_t q = 0; q < num_queries; q++)
+    {
+        ids[q] = (q*7919) % num_splines;
+        pos[q] = -0.01 + 1.02*double((q*104729) % 1000)/999;
+    }
+
+    std::vector<double> actual(num_queries*num_dims), parallel(num_queries*num_dims);
+    bank.eval(ids.data(), pos.data(), num_queries, actual.data());
+    bank.eval(ids.data(), pos.data(), num_queries, parallel.data(), 0);
+    EXPECT_EQ(actual, parallel);
+    for(std::size_t q = 0; q < num_queries; q++)
+    {
+        double expected[num_dims];
+        splines[ids[q]].eval(pos[q], expected);
+        for(std::size_t j = 0; j < num_dims; j++)
+        {
+            EXPECT_NEAR(actual[q*num_dims+j], expected[j], 1e-9);
+        }
+    }
+
+    // Points are copied, caller memory may go away
+    double expected[num_dims], out[num_dims];
+    splines[3].eval(0.5, expected);
+    points.clear();
+    bank.eval(3, 0.5, out);
+    for(std::size_t j = 0; j < num_dims; j++)
+    {
+        EXPECT_NEAR(out[j], expected[j], 1e-9);
+    }
+
+    bank.clear();
+    EXPECT_EQ(bank.size(), 0u);
+}
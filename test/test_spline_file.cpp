@@ -0,0 +1,135 @@
+/*
+ * MIT License
+ *
+ * Parametric Cubic Spline Library
+ * Copyright (c) 2021-, Michael Heidingsfeld
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "parametric_cubic_spline/spline_file.h"
+
+using namespace parametric_cubic_spline;
+
+TEST(SplineFile, MatchesBank)
+{
+    const std::size_t num_splines = 30;
+    const std::size_t num_dims = 3;
+    SplineBank<double> bank(num_dims);
+    SplineFileWriter<double> writer(num_dims);
+    std::vector<std::vector<double>> points(num_splines);
+
+    for(std::size_t k = 0; k < num_splines; k++)
+    {
+        const std::size_t num_points = 2 + (k*5) % 17;
+        const BoundaryCondition bc = k % 4 ? BoundaryCondition::Natural : BoundaryCondition::Periodic;
+        points[k].resize(num_points*num_dims);
+        for(std::size_t i = 0; i < points[k].size(); i++)
+        {
+            points[k][i] = 5.0*std::cos(0.3*i + k);
+        }
+        bank.add(points[k].data(), num_points, bc, bc);
+        EXPECT_EQ(writer.add(points[k].data(), num_points, bc, bc), k);
+    }
+
+    const std::string path = testing::TempDir() + "test_spline_file.bin";
+    ASSERT_TRUE(writer.write(path));
+
+    SplineFile<double> file;
+    ASSERT_TRUE(file.open(path));
+    EXPECT_EQ(file.size(), num_splines);
+    EXPECT_EQ(file.num_dims(), num_dims);
+
+    const std::size_t num_queries = 1000;
+    std::vector<std::size_t> ids(num_queries);
+    std::vector<double> pos(num_queries);
+    for(std::size_t q = 0; q < num_queries; q++)
+    {
+        ids[q] = (q*13) % num_splines;
+        pos[q] = -0.01 + 1.02*q/(num_queries - 1);
+    }
+    std::vector<double> expected(num_queries*num_dims), actual(num_queries*num_dims);
+    bank.eval(ids.data(), pos.data(), num_queries, expected.data());
+    file.eval(ids.data(), pos.data(), num_queries, actual.data());
+    EXPECT_EQ(actual, expected);
+
+    for(std::size_t k = 0; k < num_splines; k++)
+    {
+        ASSERT_EQ(file.num_points(k), points[k].size()/num_dims);
+        EXPECT_EQ(std::vector<double>(file.points(k), file.points(k) + points[k].size()), points[k]);
+    }
+
+    // same file viewed in memory, wrong scalar type and damaged headers are rejected
+    std::ifstream stream(path, std::ios::binary | std::ios::ate);
+    const std::size_t size = static_cast<std::size_t>(stream.tellg());
+    std::vector<std::uint64_t> buffer((size + 7)/8);
+    stream.seekg(0);
+    stream.read(reinterpret_cast<char*>(buffer.data()), size);
+
+    SplineFile<double> view;
+    ASSERT_TRUE(view.open(buffer.data(), size));
+    double a[num_dims], b[num_dims];
+    view.eval(7, 0.4, a);
+    bank.eval(7, 0.4, b);
+    EXPECT_EQ(std::memcmp(a, b, sizeof(a)), 0);
+
+    SplineFile<float> wrong_type;
+    EXPECT_FALSE(wrong_type.open(buffer.data(), size));
+    EXPECT_FALSE(view.open(buffer.data(), size - 64));
+    reinterpret_cast<unsigned char*>(buffer.data())[12] ^= 0xff;
+    EXPECT_FALSE(view.open(buffer.data(), size));
+    EXPECT_FALSE(view.is_open());
+    reinterpret_cast<unsigned char*>(buffer.data())[12] ^= 0xff;
+    ASSERT_TRUE(view.open(buffer.data(), size));
+
+    // damaged offsets: out of order, not at a segment boundary, empty spline
+    internal::SplineFileHeader header;
+    std::memcpy(&header, buffer.data(), sizeof(header));
+    std::uint64_t *offsets = buffer.data() + header.offsets_offset/8;
+    for(std::uint64_t damaged : {offsets[4] + 1000*4*num_dims, offsets[3] + 1, offsets[3]})
+    {
+        const std::uint64_t original = offsets[4];
+        offsets[4] = damaged;
+        EXPECT_FALSE(view.open(buffer.data(), size));
+        offsets[4] = original;
+    }
+
+    // sizes overflowing 64 bits
+    internal::SplineFileHeader hostile = header;
+    hostile.num_points = ~std::uint64_t(0)/2;
+    std::memcpy(buffer.data(), &hostile, sizeof(hostile));
+    EXPECT_FALSE(view.open(buffer.data(), size));
+    hostile = header;
+    hostile.points_offset = ~std::uint64_t(0) - 63;
+    std::memcpy(buffer.data(), &hostile, sizeof(hostile));
+    EXPECT_FALSE(view.open(buffer.data(), size));
+    std::memcpy(buffer.data(), &header, sizeof(header));
+    EXPECT_TRUE(view.open(buffer.data(), size));
+
+    file.close();
+    EXPECT_FALSE(file.is_open());
+    std::remove(path.c_str());
+}
@@ -0,0 +1,95 @@
+/*
+ * MIT License
+ *
+ * Parametric Cubic Spline Library
+ * Copyright (c) 2021-, Michael Heidingsfeld
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "parametric_cubic_spline/spline_file_builder.h"
+
+using namespace parametric_cubic_spline;
+
+#ifdef PARAMETRIC_CUBIC_SPLINE_HAS_MMAP
+TEST(SplineFileBuilder, MatchesSpline)
+{
+    const std::size_t num_dims = 3;
+    const double tangent[num_dims] = {1.0, -2.0, 0.5};
+    const std::string input_path = testing::TempDir() + "test_spline_file_builder.points";
+    const std::string output_path = testing::TempDir() + "test_spline_file_builder.bin";
+
+    for(std::size_t num_points : {2, 3, 1000})
+    {
+        std::vector<double> points(num_points*num_dims);
+        for(std::size_t i = 0; i < points.size(); i++) points[i] = 10.0*std::sin(0.7*i);
+        {
+            std::ofstream file(input_path, std::ios::binary | std::ios::trunc);
+            file.write(reinterpret_cast<const char*>(points.data()), points.size()*sizeof(double));
+        }
+
+        for(BoundaryCondition bc : {BoundaryCondition::Natural, BoundaryCondition::Hermite, BoundaryCondition::NotAKnot})
+        {
+            // Chunks smaller than a page exercise the release of both sweeps
+            SplineFileBuilder<double> builder(num_dims);
+            builder.set_chunk_size(7);
+            ASSERT_TRUE(builder.build(input_path, output_path, bc, bc, tangent, tangent));
+
+            Spline<double, Dynamic, Dynamic> reference;
+            reference.enable_coefficient_cache();
+            reference.set(points.data(), num_points, num_dims, bc, bc, tangent, tangent);
+            SplineFile<double> file;
+            ASSERT_TRUE(file.open(output_path));
+            ASSERT_EQ(file.size(), 1u);
+            ASSERT_EQ(file.num_points(0), num_points);
+            EXPECT_EQ(std::vector<double>(file.points(0), file.points(0) + points.size()), points);
+
+            for(std::size_t k = 0; k <= 500; k++)
+            {
+                const double pos = double(k)/500;
+                double expected[num_dims], actual[num_dims];
+                reference.eval(pos, expected);
+                file.eval(0, pos, actual);
+                for(std::size_t j = 0; j < num_dims; j++) EXPECT_NEAR(actual[j], expected[j], 1e-9);
+            }
+        }
+    }
+
+    // Unsupported boundaries and unreadable input
+    SplineFileBuilder<double> builder(num_dims);
+    EXPECT_FALSE(builder.build(input_path, output_path, BoundaryCondition::Periodic, BoundaryCondition::Periodic));
+    EXPECT_FALSE(builder.build(input_path + ".missing", output_path));
+
+    // An incomplete output is rejected, here the spill cannot be created
+    const std::string spill_path = output_path + ".spill";
+    ASSERT_EQ(::mkdir(spill_path.c_str(), 0755), 0);
+    EXPECT_FALSE(builder.build(input_path, output_path));
+    SplineFile<double> file;
+    EXPECT_FALSE(file.open(output_path));
+    ::rmdir(spill_path.c_str());
+
+    std::remove(input_path.c_str());
+    std::remove(output_path.c_str());
+}
+#endif
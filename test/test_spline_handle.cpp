@@ -0,0 +1,139 @@
+/*
+ * MIT License
+ *
+ * Parametric Cubic Spline Library
+ * Copyright (c) 2021-, Michael Heidingsfeld
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <future>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "parametric_cubic_spline/spline_handle.h"
+
+using namespace parametric_cubic_spline;
+
+TEST(SplineHandle, ReadersSeeWholeVersions)
+{
+    const std::size_t num_points = 64;
+    const std::size_t num_dims = 3;
+    const std::size_t num_updates = 2000;
+    SplineHandle<double> handle;
+    handle.reserve(num_points, num_dims);
+
+    // version k is the constant spline with all coordinates equal to k
+    std::vector<double> points(num_points*num_dims, 0.0);
+    handle.set(points.data(), num_points, num_dims);
+
+    std::atomic<bool> done(false);
+    std::vector<std::thread> readers;
+    std::vector<std::size_t> errors(4, 0);
+    for(std::size_t r = 0; r < errors.size(); r++)
+    {
+        readers.emplace_back([&, r]()
+        {
+            double last = 0.0;
+            while(!done.load())
+            {
+                auto spline = handle.read();
+                ASSERT_EQ(spline->num_points(), num_points);
+                double out[num_dims];
+                spline->eval(0.37, out);
+                // no mixed versions, versions only move forward
+                if(out[0] != out[1] || out[0] != out[2] || out[0] < last) errors[r]++;
+                last = out[0];
+            }
+        });
+    }
+
+    for(std::size_t k = 1; k <= num_updates; k++)
+    {
+        std::fill(points.begin(), points.end(), double(k));
+        handle.set(points.data(), num_points, num_dims);
+    }
+    done.store(true);
+    for(std::thread &reader : readers) reader.join();
+
+    for(std::size_t r = 0; r < errors.size(); r++) EXPECT_EQ(errors[r], 0u);
+    double out[num_dims];
+    handle.read()->eval(0.5, out);
+    EXPECT_DOUBLE_EQ(out[0], double(num_updates));
+}
+
+TEST(SplineHandle, AsyncSet)
+{
+    const std::size_t num_points = 200000;
+    const std::size_t num_dims = 2;
+    SplineHandle<double> handle;
+    Spline<double, Dynamic, Dynamic> reference;
+
+    reference.enable_coefficient_cache();
+    std::vector<double> points(num_points*num_dims, 1.0);
+    handle.set(points.data(), num_points, num_dims);
+
+    // readers keep the previous version until the new one is published
+    for(std::size_t i = 0; i < points.size(); i++) points[i] = std::sin(0.001*i);
+    const double tangent[num_dims] = {1.0, -2.0};
+    std::future<void> done = handle.async_set(points.data(), num_points, num_dims,
+        BoundaryCondition::Hermite, BoundaryCondition::Natural, tangent);
+    reference.set(points.data(), num_points, num_dims,
+        BoundaryCondition::Hermite, BoundaryCondition::Natural, tangent);
+    std::fill(points.begin(), points.end(), 3.0);
+
+    double out[num_dims], expected[num_dims];
+    reference.eval(0.3, expected);
+    handle.read()->eval(0.3, out);
+    EXPECT_TRUE(out[0] == 1.0 || std::abs(out[0] - expected[0]) < 1e-12);
+    done.get();
+    handle.read()->eval(0.3, out);
+    EXPECT_NEAR(out[0], expected[0], 1e-12);
+    EXPECT_NEAR(out[1], expected[1], 1e-12);
+
+    // the last request wins regardless of completion order
+    std::vector<std::future<void>> updates;
+    for(std::size_t k = 1; k <= 8; k++)
+    {
+        std::fill(points.begin(), points.end(), double(k));
+        updates.push_back(handle.async_set(points.data(), num_points, num_dims));
+    }
+    for(std::future<void> &update : updates) update.get();
+    handle.read()->eval(0.7, out);
+    EXPECT_EQ(out[0], 8.0);
+}
+
+TEST(SplineHandle, DestroyedWithPendingUpdates)
+{
+    // futures dropped right away, the handle waits for its queued updates
+    const std::size_t num_points = 100000;
+    const std::size_t num_dims = 2;
+    std::vector<double> points(num_points*num_dims, 1.0);
+    for(std::size_t k = 0; k < 4; k++)
+    {
+        SplineHandle<double> handle;
+        for(std::size_t i = 0; i < 8; i++)
+        {
+            handle.async_set(points.data(), num_points, num_dims);
+        }
+    }
+}
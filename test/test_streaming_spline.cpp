@@ -0,0 +1,97 @@
+/*
+ * MIT License
+ *
+ * Parametric Cubic Spline Library
+ * Copyright (c) 2021-, Michael Heidingsfeld
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include <cmath>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "parametric_cubic_spline/streaming_spline.h"
+
+using namespace parametric_cubic_spline;
+
+TEST(StreamingSpline, MatchesSplineOfAllPoints)
+{
+    const std::size_t num_points = 500;
+    const std::size_t num_dims = 3;
+    std::vector<double> points(num_points*num_dims);
+    for(std::size_t i = 0; i < points.size(); i++) points[i] = 10.0*std::sin(0.7*i);
+
+    // Window as long as the stream, and one sliding over it
+    for(std::size_t capacity : {num_points, std::size_t(100)})
+    {
+        StreamingSpline<double> spline(num_dims, capacity);
+        for(std::size_t n = 1; n <= num_points; n++)
+        {
+            spline.append(&points[(n-1)*num_dims]);
+            ASSERT_EQ(spline.num_points(), std::min(n, capacity));
+            if(n < 2 || n % 37) continue;
+
+            // Natural spline through all points received so far
+            Spline<double, Dynamic, Dynamic> reference;
+            reference.set(points.data(), n, num_dims);
+            const std::size_t window = spline.num_points();
+            for(std::size_t k = 0; k <= 100; k++)
+            {
+                const double pos = double(k)/100;
+                const double global = ((n - window) + pos*(window - 1))/(n - 1);
+                double expected[num_dims], actual[num_dims];
+                reference.eval(global, expected);
+                spline.eval(pos, actual);
+                for(std::size_t j = 0; j < num_dims; j++) EXPECT_NEAR(actual[j], expected[j], 1e-9);
+            }
+        }
+    }
+}
+
+TEST(StreamingSpline, ShortWindowIsNatural)
+{
+    const std::size_t num_points = 60;
+    const std::size_t num_dims = 2;
+    const std::size_t capacity = 8;
+    std::vector<double> points(num_points*num_dims);
+    for(std::size_t i = 0; i < points.size(); i++) points[i] = 10.0*std::sin(0.7*i);
+
+    // Window no longer than the tail, solved as a whole
+    StreamingSpline<double> spline(num_dims, capacity, 16);
+    for(std::size_t n = 1; n <= num_points; n++)
+    {
+        spline.append(&points[(n-1)*num_dims]);
+        if(n < 2) continue;
+
+        const std::size_t window = spline.num_points();
+        Spline<double, Dynamic, Dynamic> reference;
+        reference.set(&points[(n - window)*num_dims], window, num_dims);
+        for(std::size_t k = 0; k <= 50; k++)
+        {
+            const double pos = double(k)/50;
+            double expected[num_dims], actual[num_dims];
+            reference.eval(pos, expected);
+            spline.eval(pos, actual);
+            for(std::size_t j = 0; j < num_dims; j++) EXPECT_NEAR(actual[j], expected[j], 1e-9);
+        }
+    }
+
+    spline.clear();
+    EXPECT_EQ(spline.num_points(), 0u);
+}